@@ -1,4 +1,6 @@
 TEMPLATE = subdirs
 
 SUBDIRS += gui \
-    tests
+    shared \
+    tests \
+    tests/maps.pro
@@ -49,9 +49,23 @@ module API
   MATCH_START_KEY = :match_start
   MATCH_END_KEY = :match_end
 
+  WARM_ARG = "--warm"
+  RUN_PREFIX = "run#"
+
   TEXT_PREFIX = "game_text#"
+  MATCH_PREFIX = "match#"
+  STATE_PREFIX = "state#"
   EXIT_PREFIX = "exit#"
 
+  FILTER_PREFIX = "filter#"
+  FILTER_CLEAR_PREFIX = "filter_clear#"
+  PRIORITY_PREFIX = "priority#"
+  SUBSCRIBE_PREFIX = "subscribe#"
+  UNSUBSCRIBE_PREFIX = "unsubscribe#"
+
+  # seconds wait_rt gives the client to push the roundtime of the last put
+  RT_GRACE = 1.0
+
   API_ADR = '127.0.0.1'
 
   class CommThread
@@ -60,10 +74,14 @@ module API
         case
           when line.start_with?(API::TEXT_PREFIX)
             write line[API::TEXT_PREFIX.size, line.size]
+          when line.start_with?(API::MATCH_PREFIX)
+            match = JSON.parse(line[API::MATCH_PREFIX.size, line.size])
+            write MatchedLine.new("#{match["line"]}\n", match["captures"])
+          when line.start_with?(API::STATE_PREFIX)
+            State::update JSON.parse(line[API::STATE_PREFIX.size, line.size])
           when line.start_with?(API::EXIT_PREFIX)
             Kernel::abort
         end
-        sleep 0.01
       end
     end
 
@@ -77,18 +95,250 @@ module API
     end
   end
 
+  # Game line that passed the client side text filter,
+  # along with the capture groups of the matching pattern.
+  class MatchedLine < String
+    attr_reader :captures
+
+    def initialize(line, captures)
+      super(line)
+      @captures = captures
+    end
+  end
+
+  # Client side text filter; once enabled only lines matching
+  # one of the registered patterns are sent to the script.
+  module Filter
+    # patterns the script library waits on right after sending a command
+    LIBRARY = [/>/, /Roundtime/, /^\{nav\}$/, /\.\.\.wait|you may only type ahead/, /You are still stunned/,
+               /do that while (sitting|kneeling|lying)|must be standing|cannot manage to stand/,
+               /if you first retreat|You are engaged|do that while engaged/]
+
+    # the client compiles patterns as PCRE, which reads these differently:
+    # \h is a hex digit in Ruby but horizontal space in PCRE, and && in a
+    # character class is an intersection in Ruby but literal text in PCRE
+    UNPORTABLE = /(?<!\\)(?:\\\\)*\\[hH]|&&/
+
+    @patterns = {}
+    @enabled = false
+    @mutex = Mutex.new
+
+    def self.enable(patterns)
+      @mutex.synchronize { @enabled = true }
+      add LIBRARY + patterns
+    end
+
+    # registers patterns not yet known to the client; does nothing
+    # while the filter is off since every line is sent anyway. A pattern
+    # the client would match differently turns the filter off, so no
+    # line the script waits on is dropped.
+    def self.add(patterns)
+      added = []
+      refused = false
+      @mutex.synchronize do
+        return unless @enabled
+        specs = patterns.flatten.map { |pattern| Filter::spec pattern }
+        refused = specs.any? { |spec| spec["source"] =~ UNPORTABLE }
+        unless refused
+          specs.each do |spec|
+            added << spec unless @patterns.key?(spec)
+            @patterns[spec] = true
+          end
+        end
+      end
+      return Filter::clear if refused
+      unless added.empty?
+        puts "#{API::FILTER_PREFIX}#{JSON.generate(added)}#{API::API_CMD_SUFFIX}"
+      end
+    end
+
+    def self.clear
+      @mutex.synchronize do
+        @patterns.clear
+        @enabled = false
+      end
+      puts "#{API::FILTER_CLEAR_PREFIX}#{API::API_CMD_SUFFIX}"
+    end
+
+    def self.spec(pattern)
+      pattern = Regexp.new(pattern) unless pattern.is_a?(Regexp)
+      flags = ""
+      flags << "i" if pattern.options & Regexp::IGNORECASE != 0
+      flags << "m" if pattern.options & Regexp::MULTILINE != 0
+      flags << "x" if pattern.options & Regexp::EXTENDED != 0
+      {"source" => pattern.source, "flags" => flags}
+    end
+  end
+
+  # Field values pushed by the client for subscribed fields;
+  # the client only sends a field when its value changes.
+  module State
+    @values = {}
+    @updated = {}
+    @sent = nil
+    @callbacks = Hash.new { |hash, key| hash[key] = [] }
+    @mutex = Mutex.new
+    @changed = ConditionVariable.new
+
+    def self.update(values)
+      calls = []
+      @mutex.synchronize do
+        values.each_pair do |field, value|
+          key = field.downcase.to_sym
+          @values[key] = value
+          @updated[key] = Time.now
+          @callbacks[key].each { |callback| calls << [callback, value] } if @callbacks.key?(key)
+        end
+        @changed.broadcast
+      end
+      calls.each { |callback, value| callback.call value }
+    end
+
+    def self.subscribe(fields, &block)
+      added = []
+      @mutex.synchronize do
+        fields.each do |field|
+          added << field unless @callbacks.key?(field)
+          callbacks = @callbacks[field]
+          callbacks << block if block
+        end
+      end
+      unless added.empty?
+        puts "#{API::SUBSCRIBE_PREFIX}#{added.join(',').upcase}#{API::API_CMD_SUFFIX}"
+      end
+    end
+
+    def self.unsubscribe(fields)
+      @mutex.synchronize do
+        if fields.empty?
+          @callbacks.clear
+          @values.clear
+        end
+        fields.each do |field|
+          @callbacks.delete field
+          @values.delete field
+        end
+      end
+      puts "#{API::UNSUBSCRIBE_PREFIX}#{fields.join(',').upcase}#{API::API_CMD_SUFFIX}"
+    end
+
+    def self.subscribed?(field)
+      @mutex.synchronize { @values.key?(field) }
+    end
+
+    def self.value(field)
+      @mutex.synchronize { @values[field] }
+    end
+
+    # time of the last command sent to the game
+    def self.sent
+      @mutex.synchronize { @sent = Time.now }
+    end
+
+    # waits for a push of the field newer than the last command, at most grace seconds after it
+    def self.wait_update(field, grace)
+      @mutex.synchronize do
+        return if @sent.nil?
+        deadline = @sent + grace
+        until @updated.key?(field) && @updated[field] > @sent
+          remaining = deadline - Time.now
+          return if remaining <= 0
+          @changed.wait(@mutex, remaining)
+        end
+      end
+    end
+
+    # blocks on the condition variable; no polling
+    def self.wait(field, timeout = nil)
+      deadline = Time.now + timeout if timeout
+      @mutex.synchronize do
+        until @values.key?(field) && yield(@values[field])
+          remaining = deadline ? deadline - Time.now : nil
+          return false if remaining && remaining <= 0
+          @changed.wait(@mutex, remaining)
+        end
+        true
+      end
+    end
+  end
+
   module Client
-    def self.api_port
+    # value from the [ApiServer] section of api.ini
+    def self.api_value(key)
       File.open("#{File.dirname(__FILE__)}/../../api.ini", 'r') do |inFile|
+        section = nil
         inFile.each_line do |line|
-          return line.partition('=').last.to_i if line.start_with? "port"
+          section = line.strip if line.start_with? "["
+          return line.partition('=').last.strip if section == "[ApiServer]" && line.start_with?("#{key}=")
         end
       end
+      ""
+    end
+
+    def self.api_port
+      Client::api_value("port").to_i
+    end
+
+    # unix domain socket path, empty when the client does not provide one
+    def self.api_socket
+      Client::api_value("socket")
+    end
+
+    def self.open
+      path = Client::api_socket
+      if defined?(UNIXSocket) && !path.empty? && File.socket?(path)
+        UNIXSocket.open(path)
+      else
+        socket = TCPSocket.open(API::API_ADR, Client::api_port)
+        socket.setsockopt(Socket::IPPROTO_TCP, Socket::TCP_NODELAY, 1)
+        socket
+      end
     end
 
     def self.init
-      $_api_socket = TCPSocket.open(API::API_ADR, Client::api_port)
-      $_api_socket.setsockopt(Socket::IPPROTO_TCP, Socket::TCP_NODELAY, 1)
+      $_api_socket = Client::open
+    end
+  end
+
+  # Framed connection (api protocol 2); replies carry the request id
+  # so several requests can be sent before reading.
+  module Framed
+    HEADER = 'NN'
+    HEADER_SIZE = 8
+
+    def self.socket
+      @socket ||= begin
+        socket = Client::open
+        socket.puts "PROTOCOL 2\n"
+        socket.gets('\0')
+        socket
+      end
+    end
+
+    def self.send_request(payload)
+      @id = (@id || 0) + 1
+      body = JSON.generate(payload)
+      socket.write([body.bytesize + 4, @id].pack(HEADER) + body)
+      @id
+    end
+
+    def self.read_reply
+      length, id = socket.read(HEADER_SIZE).unpack(HEADER)
+      [id, JSON.parse(socket.read(length - 4).force_encoding('UTF-8'))]
+    end
+
+    def self.request(payload)
+      pipeline([payload]).first
+    end
+
+    def self.pipeline(payloads)
+      ids = payloads.map { |payload| send_request payload }
+      replies = {}
+      ids.size.times do
+        id, reply = read_reply
+        replies[id] = reply
+      end
+      ids.map { |id| replies[id] }
     end
   end
 
@@ -160,6 +410,7 @@ def put(value)
     $_api_queue.clear
     puts "#{API::API_PUT_PREFIX}#{value.to_s}#{API::API_CMD_SUFFIX}"
   end
+  API::State::sent
 end
 
 # Put and match.
@@ -242,6 +493,89 @@ def pause_rt
   end
 end
 
+# Lets the client do the text matching: from now on only game lines
+# matching one of the patterns (or a pattern the script library itself
+# waits on) are sent to the script. Patterns used later by match_wait,
+# wait_for or the Observer are added automatically, but register them here
+# if their text may arrive before the wait starts.
+#
+# Matched lines carry the capture groups of the matching pattern.
+#
+# @param [Array<Regexp, String>] patterns patterns the script needs to see
+# @return [void]
+# @example Only ship combat messages to the script.
+#   text_filter /You (hit|miss)/, /falls? to the ground/
+#   result = match_get({ :hit => [/You hit .* (\w+)\.$/] })
+#   echo result[:match].captures.first
+def text_filter(*patterns)
+  API::Filter::enable patterns
+end
+
+# Turns the client side text filter off; all game text is sent again.
+#
+# @return [void]
+def text_filter_clear
+  API::Filter::clear
+end
+
+# Sets the priority of this script's commands. When several scripts
+# send commands at the same time the client interleaves them one per
+# script, starting with the highest priority.
+#
+# @param [Integer] value priority, default 0
+# @return [void]
+def script_priority(value)
+  puts "#{API::PRIORITY_PREFIX}#{value.to_i}#{API::API_CMD_SUFFIX}"
+end
+
+# Subscribes to client state; new values are pushed by the client
+# only when they change, so scripts do not need to poll.
+#
+# Fields: :rt, :ct, :health, :concentration, :spirit, :mana, :fatigue,
+# :standing, :sitting, :kneeling, :prone, :stunned, :bleeding, :hidden,
+# :invisible, :webbed, :joined, :dead, :room_id, :active_spells, :exp_pulse
+#
+# @param [Array<Symbol>] fields fields to subscribe to
+# @yield [value] optional callback, runs on the script input thread
+# @return [void]
+# @example Echo every exp pulse.
+#   subscribe(:exp_pulse) { |skill| echo "#{skill} pulsed" }
+def subscribe(*fields, &block)
+  API::State::subscribe fields, &block
+end
+
+# Stops pushing values for the given fields, or all fields if none given.
+#
+# @param [Array<Symbol>] fields fields to unsubscribe from
+# @return [void]
+def unsubscribe(*fields)
+  API::State::unsubscribe fields
+end
+
+# Waits until the value of a subscribed field matches the block.
+#
+# @param [Symbol] field field name
+# @param [Integer, Float] timeout maximum wait in seconds, waits forever when nil
+# @return [Boolean] false if the timeout expired
+# @example Wait for concentration to recover.
+#   wait_state(:concentration) { |value| value > 90 }
+def wait_state(field, timeout = nil, &block)
+  subscribe field
+  API::State::wait field, timeout, &block
+end
+
+# Waits until round time ends; returns as soon as the client
+# reports zero instead of sleeping a whole second at a time.
+# Right after a put the cached value is still the old one, so it
+# first waits up to API::RT_GRACE seconds for the new roundtime.
+#
+# @return [void]
+def wait_rt
+  subscribe :rt
+  API::State::wait_update :rt, API::RT_GRACE
+  wait_state(:rt) { |rt| rt == 0 }
+end
+
 # @private
 def exit
   Kernel::exit
@@ -265,6 +599,16 @@ end
 # init IPC
 API::Client::init
 
+# started ahead of time by the client: the library is loaded
+# and connected, wait to be told which script to run
+if @_file == API::WARM_ARG
+  line = STDIN.gets
+  Kernel::exit unless line && line.start_with?(API::RUN_PREFIX)
+  run = JSON.parse(line[API::RUN_PREFIX.size, line.size])
+  @_file = run["file"]
+  $args = run["args"].map { |arg| CGI.unescapeHTML(arg) }
+end
+
 # wait for round time
 # before executing script
 sleep Rt::value
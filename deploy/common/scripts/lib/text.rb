@@ -24,6 +24,7 @@ end
 # @return [void]
 def wait_for(pattern)
   $_api_exec_state = :wait_for
+  API::Filter::add [pattern]
   if pattern.is_a?(Array)
     pattern = Regexp.new(pattern.join('|'))
   end
@@ -164,6 +165,7 @@ end
 
 # @private
 def api_get_match pattern, match
+  API::Filter::add pattern.values
   api_match_start pattern
 
   match_found, rt = false, 0
@@ -2,16 +2,29 @@ require 'socket'
 require 'dl'
 require 'dl/import'
 require 'benchmark'
+require 'json'
 
 start = Time.now
 
 module ApiSettings
-  def self.port
+  # value from the [ApiServer] section of api.ini
+  def self.value(key)
     File.open("api.ini", 'r') do |inFile|
+      section = nil
       inFile.each_line do |line|
-        return line.partition('=').last.to_i if line.start_with? "port"
+        section = line.strip if line.start_with? "["
+        return line.partition('=').last.strip if section == "[ApiServer]" && line.start_with?("#{key}=")
       end
     end
+    ""
+  end
+
+  def self.port
+    ApiSettings::value("port").to_i
+  end
+
+  def self.socket
+    ApiSettings::value("socket")
   end
 end
 
@@ -51,6 +64,29 @@ class Container
   end
 end
 
+module Framed
+  def self.open
+    $_api_framed = TCPSocket.open('127.0.0.1', ApiSettings::port)
+    $_api_framed.setsockopt(Socket::IPPROTO_TCP, Socket::TCP_NODELAY, 1)
+    $_api_framed.puts "PROTOCOL 2\n"
+    $_api_framed.gets('\0')
+  end
+
+  def self.request(id, payload)
+    body = JSON.generate(payload)
+    $_api_framed.write([body.bytesize + 4, id].pack('NN') + body)
+  end
+
+  def self.reply
+    length, id = $_api_framed.read(8).unpack('NN')
+    JSON.parse($_api_framed.read(length - 4))
+  end
+end
+
+Framed::open
+
+$_api_unix = UNIXSocket.open(ApiSettings::socket) unless ApiSettings::socket.empty?
+
 # @api private
 module GameData
   extend DL::Importer
@@ -68,4 +104,22 @@ Benchmark.bm do |x|
   x.report("Socket Container") {
     n.times do Container::list end
   }
+  x.report("Unix socket RT") {
+    n.times do
+      $_api_unix.puts "GET RT\n"
+      $_api_unix.gets('\0').chomp('\0').to_i
+    end
+  } if $_api_unix
+  x.report("Framed RT") {
+    n.times do |i| Framed::request(i, {:get => ["RT"]}); Framed::reply end
+  }
+  x.report("Framed snapshot") {
+    n.times do |i| Framed::request(i, {:get => ["RT", "HEALTH", "STANDING", "WIELD_RIGHT"]}); Framed::reply end
+  }
+  x.report("Framed pipelined RT") {
+    (n / 100).times do
+      100.times do |i| Framed::request(i, {:get => ["RT"]}) end
+      100.times do Framed::reply end
+    end
+  }
 end
\ No newline at end of file
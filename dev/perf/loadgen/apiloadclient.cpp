@@ -0,0 +1,72 @@
+#include "apiloadclient.h"
+
+#include <QRandomGenerator>
+
+ApiLoadClient::ApiLoadClient(quint16 port, QList<QPair<QString, QStringList> > mix, QObject *parent) : QObject(parent) {
+    this->port = port;
+    this->mix = mix;
+    running = false;
+    errors = 0;
+
+    connect(&socket, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    connect(&socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(onError(QAbstractSocket::SocketError)));
+}
+
+void ApiLoadClient::start() {
+    running = true;
+    socket.connectToHost("127.0.0.1", port);
+}
+
+void ApiLoadClient::stop() {
+    running = false;
+    socket.disconnectFromHost();
+}
+
+QHash<QString, LatencyStats>& ApiLoadClient::getStats() {
+    return stats;
+}
+
+int ApiLoadClient::getErrors() {
+    return errors;
+}
+
+void ApiLoadClient::onConnected() {
+    socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    this->sendNext();
+}
+
+/* picks a request type by weight, then one of its requests at random */
+void ApiLoadClient::sendNext() {
+    if(!running || mix.isEmpty()) return;
+
+    QRandomGenerator* random = QRandomGenerator::global();
+    int index = random->bounded(mix.size());
+    const QPair<QString, QStringList>& type = mix.at(index);
+
+    pending = type.first;
+    QString request = type.second.at(random->bounded(type.second.size()));
+
+    timer.start();
+    socket.write(request.toLocal8Bit() + "\n");
+}
+
+void ApiLoadClient::onReadyRead() {
+    buffer.append(socket.readAll());
+
+    // replies end with a literal \0
+    int end = buffer.indexOf("\\0");
+    while(end > -1) {
+        stats[pending].add(timer.nsecsElapsed() / 1000);
+        buffer.remove(0, end + 2);
+        end = buffer.indexOf("\\0");
+        this->sendNext();
+    }
+}
+
+void ApiLoadClient::onError(QAbstractSocket::SocketError) {
+    if(running) {
+        errors++;
+        qWarning("api client: %s", qPrintable(socket.errorString()));
+    }
+}
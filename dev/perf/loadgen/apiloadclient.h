@@ -0,0 +1,46 @@
+#ifndef APILOADCLIENT_H
+#define APILOADCLIENT_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+#include "latencystats.h"
+
+/* Sends one request at a time over the text protocol, the way the
+   ruby library does, and records the round trip of each one. */
+class ApiLoadClient : public QObject {
+    Q_OBJECT
+
+public:
+    ApiLoadClient(quint16 port, QList<QPair<QString, QStringList> > mix, QObject *parent = 0);
+
+    void start();
+    void stop();
+
+    QHash<QString, LatencyStats>& getStats();
+    int getErrors();
+
+private:
+    quint16 port;
+    QTcpSocket socket;
+    QList<QPair<QString, QStringList> > mix;
+    QHash<QString, LatencyStats> stats;
+    QElapsedTimer timer;
+    QByteArray buffer;
+    QString pending;
+    bool running;
+    int errors;
+
+    void sendNext();
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onError(QAbstractSocket::SocketError);
+};
+
+#endif // APILOADCLIENT_H
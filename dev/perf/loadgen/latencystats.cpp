@@ -0,0 +1,46 @@
+#include "latencystats.h"
+
+#include <algorithm>
+
+LatencyStats::LatencyStats() {
+    sorted = true;
+}
+
+void LatencyStats::add(qint64 us) {
+    samples.append(us);
+    sorted = false;
+}
+
+void LatencyStats::merge(const LatencyStats& other) {
+    samples += other.samples;
+    sorted = false;
+}
+
+int LatencyStats::count() const {
+    return samples.size();
+}
+
+void LatencyStats::sort() {
+    if(!sorted) {
+        std::sort(samples.begin(), samples.end());
+        sorted = true;
+    }
+}
+
+qint64 LatencyStats::percentile(double p) {
+    if(samples.isEmpty()) return 0;
+    this->sort();
+    int index = qMin(samples.size() - 1, (int)(p / 100.0 * samples.size()));
+    return samples.at(index);
+}
+
+qint64 LatencyStats::max() {
+    if(samples.isEmpty()) return 0;
+    this->sort();
+    return samples.last();
+}
+
+QString LatencyStats::summary() {
+    return QString("p50 %1us, p90 %2us, p99 %3us, max %4us")
+            .arg(percentile(50)).arg(percentile(90)).arg(percentile(99)).arg(max());
+}
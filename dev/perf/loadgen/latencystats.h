@@ -0,0 +1,29 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <QVector>
+#include <QString>
+
+/* latency samples in microseconds */
+class LatencyStats {
+
+public:
+    LatencyStats();
+
+    void add(qint64 us);
+    void merge(const LatencyStats& other);
+
+    int count() const;
+    qint64 percentile(double p);
+    qint64 max();
+
+    QString summary();
+
+private:
+    QVector<qint64> samples;
+    bool sorted;
+
+    void sort();
+};
+
+#endif // LATENCYSTATS_H
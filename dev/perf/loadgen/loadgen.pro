@@ -0,0 +1,22 @@
+QT       += core network
+QT       -= gui
+
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+TARGET = loadgen
+
+SOURCES += \
+    main.cpp \
+    loadgenerator.cpp \
+    apiloadclient.cpp \
+    streamloadclient.cpp \
+    latencystats.cpp
+
+HEADERS += \
+    loadgenerator.h \
+    apiloadclient.h \
+    streamloadclient.h \
+    latencystats.h
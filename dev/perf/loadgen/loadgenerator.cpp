@@ -0,0 +1,127 @@
+#include "loadgenerator.h"
+
+#include <QTimer>
+#include <QTextStream>
+#include <QMap>
+
+#include "apiloadclient.h"
+#include "streamloadclient.h"
+#include "latencystats.h"
+
+LoadGenerator::LoadGenerator(const LoadOptions& options, QObject *parent) : QObject(parent) {
+    this->options = options;
+}
+
+/* "GET=70,MAP_GET=20,PUT=10"; each type is listed as often as its weight */
+QList<QPair<QString, QStringList> > LoadGenerator::parseMix() {
+    QHash<QString, QStringList> requests;
+    requests.insert("GET", QStringList() << "GET RT" << "GET HEALTH" << "GET CONTAINER" <<
+                    "GET ROOM_TITLE" << "GET ROOM_EXITS" << "GET ACTIVE_SPELLS" << "GET EXP_RANK?athletics");
+    requests.insert("MAP_GET", QStringList() << "MAP_GET CURRENT_ROOM" << "MAP_GET ZONES");
+    if(!options.zone.isEmpty()) {
+        // zone:from:to
+        QStringList path = options.zone.split(':');
+        if(path.size() == 3) requests["MAP_GET"] << "MAP_GET PATH?" + path.join("&");
+    }
+    requests.insert("PUT", QStringList() << "PUT ECHO?loadgen");
+
+    QList<QPair<QString, QStringList> > mix;
+    foreach (QString entry, options.mix.split(',', QString::SkipEmptyParts)) {
+        QString type = entry.section('=', 0, 0).trimmed().toUpper();
+        int weight = entry.section('=', 1, 1).toInt();
+        if(!requests.contains(type)) {
+            qWarning("unknown request type %s", qPrintable(type));
+            continue;
+        }
+        for(int i = 0; i < weight; i++) {
+            mix << qMakePair(type, requests.value(type));
+        }
+    }
+    return mix;
+}
+
+bool LoadGenerator::start() {
+    QList<QPair<QString, QStringList> > mix = this->parseMix();
+    if(options.apiClients > 0 && (options.apiPort == 0 || mix.isEmpty())) {
+        qWarning("api port or request mix missing");
+        return false;
+    }
+    if(options.streamClients > 0 && options.streamPort == 0) {
+        qWarning("stream port missing");
+        return false;
+    }
+
+    for(int i = 0; i < options.streamClients; i++) {
+        StreamLoadClient* client = new StreamLoadClient(options.streamPort, options.events, options.lateMs, this);
+        streamClients << client;
+        client->start();
+    }
+    for(int i = 0; i < options.apiClients; i++) {
+        ApiLoadClient* client = new ApiLoadClient(options.apiPort, mix, this);
+        apiClients << client;
+        client->start();
+    }
+
+    elapsed.start();
+    QTimer::singleShot(options.duration * 1000, this, SLOT(finish()));
+    return true;
+}
+
+void LoadGenerator::finish() {
+    foreach (ApiLoadClient* client, apiClients) client->stop();
+    foreach (StreamLoadClient* client, streamClients) client->stop();
+
+    this->report();
+    emit done();
+}
+
+void LoadGenerator::report() {
+    QTextStream out(stdout);
+    double seconds = elapsed.elapsed() / 1000.0;
+
+    if(!apiClients.isEmpty()) {
+        QMap<QString, LatencyStats> byType;
+        LatencyStats all;
+        int errors = 0;
+        foreach (ApiLoadClient* client, apiClients) {
+            QHash<QString, LatencyStats>& stats = client->getStats();
+            foreach (QString type, stats.keys()) {
+                byType[type].merge(stats.value(type));
+                all.merge(stats.value(type));
+            }
+            errors += client->getErrors();
+        }
+        out << "api: " << apiClients.size() << " clients, " << all.count() << " requests, "
+            << QString::number(all.count() / seconds, 'f', 0) << " req/s, " << errors << " errors" << endl;
+        out << "  all      " << all.summary() << endl;
+        foreach (QString type, byType.keys()) {
+            out << "  " << type.leftJustified(8) << " " << byType[type].summary() << endl;
+        }
+    }
+
+    if(!streamClients.isEmpty()) {
+        qint64 most = 0;
+        foreach (StreamLoadClient* client, streamClients) most = qMax(most, client->getMessages());
+
+        LatencyStats lag;
+        qint64 messages = 0, bytes = 0, missing = 0;
+        int late = 0, disconnected = 0;
+        foreach (StreamLoadClient* client, streamClients) {
+            messages += client->getMessages();
+            bytes += client->getBytes();
+            late += client->getLate();
+            // every client is sent the same messages, a shortfall against
+            // the best client is what was dropped for it
+            missing += most - client->getMessages();
+            if(client->wasDisconnected()) disconnected++;
+            lag.merge(client->getLag());
+        }
+        out << "stream: " << streamClients.size() << " clients, " << messages << " messages, "
+            << QString::number(bytes / seconds / 1024, 'f', 1) << " KiB/s, "
+            << missing << " dropped, " << late << " late (>" << options.lateMs << "ms), "
+            << disconnected << " disconnected" << endl;
+        if(options.events) {
+            out << "  lag      " << lag.summary() << endl;
+        }
+    }
+}
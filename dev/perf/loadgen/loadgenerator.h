@@ -0,0 +1,47 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QStringList>
+
+class ApiLoadClient;
+class StreamLoadClient;
+
+struct LoadOptions {
+    int apiClients;
+    int streamClients;
+    int duration;
+    quint16 apiPort;
+    quint16 streamPort;
+    QString mix;
+    bool events;
+    int lateMs;
+    QString zone;
+};
+
+class LoadGenerator : public QObject {
+    Q_OBJECT
+
+public:
+    explicit LoadGenerator(const LoadOptions& options, QObject *parent = 0);
+
+    bool start();
+
+private:
+    LoadOptions options;
+    QList<ApiLoadClient*> apiClients;
+    QList<StreamLoadClient*> streamClients;
+    QElapsedTimer elapsed;
+
+    QList<QPair<QString, QStringList> > parseMix();
+    void report();
+
+signals:
+    void done();
+
+private slots:
+    void finish();
+};
+
+#endif // LOADGENERATOR_H
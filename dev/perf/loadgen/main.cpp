@@ -0,0 +1,52 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSettings>
+
+#include "loadgenerator.h"
+
+/* Load generator for the script api and stream servers of a running client.
+ *
+ *   loadgen --api 8 --stream 4 --events --duration 30 --mix GET=70,MAP_GET=20,PUT=10
+ *
+ * Ports are read from api.ini in the client directory unless given. */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Frostbite script interface load generator");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"api", "Concurrent api clients.", "n", "4"},
+        {"stream", "Concurrent stream clients.", "n", "1"},
+        {"duration", "Run time in seconds.", "s", "10"},
+        {"mix", "Request mix by weight.", "mix", "GET=70,MAP_GET=20,PUT=10"},
+        {"path", "Adds MAP_GET PATH requests for zone:from:to.", "path"},
+        {"events", "Read the stream in event mode and measure lag."},
+        {"late", "Lag after which a stream message counts as late.", "ms", "100"},
+        {"ini", "The client's api.ini.", "file", "api.ini"},
+        {"api-port", "Api server port.", "port"},
+        {"stream-port", "Stream server port.", "port"}
+    });
+    parser.process(app);
+
+    QSettings ini(parser.value("ini"), QSettings::IniFormat);
+
+    LoadOptions options;
+    options.apiClients = parser.value("api").toInt();
+    options.streamClients = parser.value("stream").toInt();
+    options.duration = parser.value("duration").toInt();
+    options.mix = parser.value("mix");
+    options.zone = parser.value("path");
+    options.events = parser.isSet("events");
+    options.lateMs = parser.value("late").toInt();
+    options.apiPort = parser.isSet("api-port") ? parser.value("api-port").toUShort() :
+                                                 ini.value("ApiServer/port").toUInt();
+    options.streamPort = parser.isSet("stream-port") ? parser.value("stream-port").toUShort() :
+                                                       ini.value("StreamServer/port").toUInt();
+
+    LoadGenerator generator(options);
+    QObject::connect(&generator, SIGNAL(done()), &app, SLOT(quit()));
+    if(!generator.start()) return 1;
+
+    return app.exec();
+}
@@ -0,0 +1,76 @@
+#include "streamloadclient.h"
+
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+StreamLoadClient::StreamLoadClient(quint16 port, bool events, int lateMs, QObject *parent) : QObject(parent) {
+    this->port = port;
+    this->events = events;
+    this->lateMs = lateMs;
+    running = false;
+    disconnected = false;
+    messages = 0;
+    bytes = 0;
+    late = 0;
+
+    connect(&socket, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    connect(&socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+}
+
+void StreamLoadClient::start() {
+    running = true;
+    socket.connectToHost("127.0.0.1", port);
+}
+
+void StreamLoadClient::stop() {
+    running = false;
+    socket.disconnectFromHost();
+}
+
+qint64 StreamLoadClient::getMessages() {
+    return messages;
+}
+
+qint64 StreamLoadClient::getBytes() {
+    return bytes;
+}
+
+int StreamLoadClient::getLate() {
+    return late;
+}
+
+bool StreamLoadClient::wasDisconnected() {
+    return disconnected;
+}
+
+LatencyStats& StreamLoadClient::getLag() {
+    return lag;
+}
+
+void StreamLoadClient::onConnected() {
+    if(events) socket.write("EVENTS\n");
+}
+
+void StreamLoadClient::onReadyRead() {
+    while(socket.canReadLine()) {
+        QByteArray line = socket.readLine();
+        bytes += line.size();
+        messages++;
+
+        if(events) {
+            qint64 ts = QJsonDocument::fromJson(line).object().value("ts").toVariant().toLongLong();
+            if(ts > 0) {
+                qint64 ms = QDateTime::currentMSecsSinceEpoch() - ts;
+                lag.add(ms * 1000);
+                if(ms > lateMs) late++;
+            }
+        }
+    }
+}
+
+/* the server cuts off clients that do not keep up */
+void StreamLoadClient::onDisconnected() {
+    if(running) disconnected = true;
+}
@@ -0,0 +1,45 @@
+#ifndef STREAMLOADCLIENT_H
+#define STREAMLOADCLIENT_H
+
+#include <QObject>
+#include <QTcpSocket>
+
+#include "latencystats.h"
+
+/* Reads the stream server. In event mode every event carries the time
+   it was produced, which gives the delivery lag of each message. */
+class StreamLoadClient : public QObject {
+    Q_OBJECT
+
+public:
+    StreamLoadClient(quint16 port, bool events, int lateMs, QObject *parent = 0);
+
+    void start();
+    void stop();
+
+    qint64 getMessages();
+    qint64 getBytes();
+    int getLate();
+    bool wasDisconnected();
+    LatencyStats& getLag();
+
+private:
+    quint16 port;
+    QTcpSocket socket;
+    bool events;
+    int lateMs;
+    bool running;
+    bool disconnected;
+
+    qint64 messages;
+    qint64 bytes;
+    int late;
+    LatencyStats lag;
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+};
+
+#endif // STREAMLOADCLIENT_H
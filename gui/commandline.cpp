@@ -12,6 +12,7 @@
 #include "macroservice.h"
 #include "windowfacade.h"
 #include "scriptservice.h"
+#include "scriptstreamserver.h"
 #include "tcpclient.h"
 #include "mainlogger.h"
 #include "maps/mapfacade.h"
@@ -87,6 +88,7 @@ void CommandLine::setCmdBgColor(QColor color) {
     QPalette p = this->palette();
     p.setColor(QPalette::Base, color);
     this->setPalette(p);
+    roundtimeDisplay->repaint();
 }
 
 RoundTimeDisplay* CommandLine::getRoundtimeDisplay() {
@@ -139,11 +141,9 @@ void CommandLine::insertRt(QPixmap segmentDisplay, QPixmap numericDisplay) {
     QPainter painter(&collage);
     painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
 
-    painter.drawPixmap(QRectF(0, 0, segmentDisplay.width(), segmentDisplay.height()), segmentDisplay,
-                       QRectF(0, 0, segmentDisplay.width(), segmentDisplay.height()));
-
-    painter.drawPixmap(QRectF(this->width() - 40, 0, numericDisplay.width(), numericDisplay.height()), numericDisplay,
-                       QRectF(0, 0, numericDisplay.width(), numericDisplay.height()));
+    // displays come pre-rendered at the device pixel ratio
+    painter.drawPixmap(QPointF(0, 0), segmentDisplay);
+    painter.drawPixmap(QPointF(this->width() - 40, 0), numericDisplay);
 
     pal.setBrush(QPalette::Base, QBrush(collage));
     this->setPalette(pal);
@@ -277,6 +277,16 @@ bool CommandLine::filterCommand(QString text) {
             mainWindow->saveLayout();
         } else if(text.startsWith("#restoreLayout")) {
             mainWindow->restoreLayout(text.mid(14).trimmed());
+        } else if(text.startsWith("#scripts")) {
+            mainWindow->getScriptService()->listScripts();
+        } else if(text.startsWith("#streamClients")) {
+            QStringList stats = mainWindow->getScriptStreamServer()->clientStats();
+            if(stats.isEmpty()) stats << "No stream clients connected.";
+            foreach(QString line, stats) {
+                mainWindow->getWindowFacade()->writeGameWindow("[" + line.toLocal8Bit() + "]");
+            }
+        } else if(text.startsWith("#abortScript")) {
+            mainWindow->getScriptService()->abortScript(text.mid(12).trimmed());
         }
         this->clear();
         return true;
@@ -2,9 +2,10 @@
 
 #include "windowfacade.h"
 #include "navigationdefines.h"
+#include "pixmapatlas.h"
 
 Compass::Compass(QObject *parent) : QObject(parent) {
-    images = new QHash<bool, QList<QPixmap> >;
+    pixmapAtlas = PixmapAtlas::Instance();
 
     /* preload images to memory */
     this->loadImages();
@@ -30,42 +31,56 @@ void Compass::setAutoPilot(bool enable) {
     state[6] = enable;
 }
 
-void Compass::loadImages() {
-    active << QPixmap(A_UP) << QPixmap(A_NW) << QPixmap(A_N) << QPixmap(A_NE)
-           << QPixmap(A_OUT) << QPixmap(A_W) << QPixmap(A_C) << QPixmap(A_E)
-           << QPixmap(A_DOWN) << QPixmap(A_SW) << QPixmap(A_S) << QPixmap(A_SE);
-
-    images->insert(true, active);
+QBitArray Compass::getState() {
+    QBitArray bits(state.size());
+    for(int i = 0; i < state.size(); i++) {
+        bits.setBit(i, state.at(i));
+    }
+    return bits;
+}
 
-    inactive << QPixmap(I_UP) << QPixmap(I_NW) << QPixmap(I_N) << QPixmap(I_NE)
-             << QPixmap(I_OUT) << QPixmap(I_W) << QPixmap(I_C) << QPixmap(I_E)
-             << QPixmap(I_DOWN) << QPixmap(I_SW) << QPixmap(I_S) << QPixmap(I_SE);
+void Compass::loadImages() {
+    QStringList active = QStringList() << A_UP << A_NW << A_N << A_NE << A_OUT << A_W
+            << A_C << A_E << A_DOWN << A_SW << A_S << A_SE;
+    QStringList inactive = QStringList() << I_UP << I_NW << I_N << I_NE << I_OUT << I_W
+            << I_C << I_E << I_DOWN << I_SW << I_S << I_SE;
+
+    images.insert(true, active);
+    images.insert(false, inactive);
+
+    /* arrows are drawn at their resource size; the atlas renders
+     * them at the current pixel ratio */
+    foreach(QString image, active) {
+        QSize size = QImageReader(image).size();
+        sizes << size;
+        pixmapAtlas->pixmap(image, size);
+        pixmapAtlas->pixmap(inactive.at(sizes.size() - 1), size);
+    }
+}
 
-    images->insert(false, inactive);
+QPixmap Compass::image(int index) {
+    return pixmapAtlas->pixmap(images.value(state.at(index)).at(index), sizes.at(index));
 }
 
 QPixmap Compass::paint() {
-    QPixmap collage(94, 69);
-    collage.fill(Qt::transparent);
-
-    QPainter painter(&collage);
-    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-
-    int x = 0, y = 0, z = 0;
+    QString key = "compass/";
+    for(int i = 0; i < state.size(); i++) {
+        key += state.at(i) ? '1' : '0';
+    }
 
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 4; j++) {
-            QPixmap image = images->value(state.at(z)).at(z);
-            painter.drawPixmap(x, y, image);
+    return pixmapAtlas->render(key, QSize(94, 69), [this](QPainter& painter) {
+        int x = 0, y = 0, z = 0;
 
-            x += image.width();
-            z++;
-       }
-       x = 0, y += 20;
-    }
-    painter.end();
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 4; j++) {
+                painter.drawPixmap(x, y, this->image(z));
 
-    return collage;
+                x += sizes.at(z).width();
+                z++;
+           }
+           x = 0, y += 20;
+        }
+    });
 }
 
 void Compass::paint(QWidget* widget, QRect rect) {
@@ -76,12 +91,12 @@ void Compass::paint(QWidget* widget, QRect rect) {
 
     for(int i = 3; i > 0; i--) {
         for(int j = 4; j > 0; j--) {
-            QPixmap image = images->value(state.at(z)).at(z);
-            painter.drawPixmap(rect.width() + x - image.width(),
-                               rect.height() + y - image.height(),
-                               image);
+            QSize size = sizes.at(z);
+            painter.drawPixmap(rect.width() + x - size.width(),
+                               rect.height() + y - size.height(),
+                               this->image(z));
 
-            x -= image.width();
+            x -= size.width();
             z--;
         }
         x = 0, y -= 20;
@@ -91,5 +106,4 @@ void Compass::paint(QWidget* widget, QRect rect) {
 
 
 Compass::~Compass(){
-    delete images;
 }
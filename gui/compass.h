@@ -5,6 +5,7 @@
 #include <QtGui>
 
 class WindowFacade;
+class PixmapAtlas;
 
 class Compass : public QObject {
     Q_OBJECT
@@ -17,19 +18,20 @@ public:
     void paint(QWidget* widget, QRect);
     void updateState(QList<QString>);
     void setAutoPilot(bool);
+    QBitArray getState();
 
 private:
     WindowFacade* wm;
+    PixmapAtlas* pixmapAtlas;
 
-    QHash<bool, QList<QPixmap> > *images;
-
-    QList<QPixmap> active;
-    QList<QPixmap> inactive;
+    QHash<bool, QStringList> images;
+    QList<QSize> sizes;
 
     QList<bool> state;
     QList<QString> dir;
 
     void loadImages();
+    QPixmap image(int index);
 };
 
 #endif // COMPASS_H
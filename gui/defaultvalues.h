@@ -98,6 +98,31 @@
 #define SCRIPT_LICH_ARGS "--dragonrealms --frostbite -g $host:$port"
 
 #define SCRIPT_STREAMING_ENABLED false
+// per client: queued bytes before the overflow policy applies, dropOldest, disconnect or block
+#define SCRIPT_STREAM_QUEUE_LIMIT 1048576
+#define SCRIPT_STREAM_OVERFLOW "dropOldest"
+#define SCRIPT_STREAM_WRITE_CHUNK 65536
+#define SCRIPT_STREAM_BLOCK_TIMEOUT 2000
+
+// game text for the script is batched until the buffer fills or the deadline passes
+#define SCRIPT_WRITE_BUFFER_SIZE 16384
+#define SCRIPT_FLUSH_INTERVAL 5
+
+// interpreters kept started with the script library loaded
+#define SCRIPT_POOL_SIZE 1
+#define SCRIPT_POOL_DELAY 3000
+#define SCRIPT_WARM_ARG "--warm"
+
+// time waitForRt gives the client to report the roundtime of the last put
+#define JS_RT_GRACE 1000
+
+#ifdef Q_OS_LINUX
+#define SCRIPT_LOCAL_SOCKET_ENABLED true
+#else
+#define SCRIPT_LOCAL_SOCKET_ENABLED false
+#endif
+#define SCRIPT_LOCAL_SOCKET(name) QDir::tempPath() + "/frostbite-" + name + "-" + \
+    QString::number(QCoreApplication::applicationPid()) + ".sock"
 
 #define WINDOW_FONT_ID "windowFont"
 #define WINDOW_FONT_SET "Set Font"
@@ -1,6 +1,9 @@
 #include "gamedatacontainer.h"
 
 #include "textutils.h"
+#include "shareddataservice.h"
+
+#include <functional>
 
 GameDataContainer* GameDataContainer::m_pInstance = NULL;
 
@@ -12,6 +15,8 @@ GameDataContainer* GameDataContainer::Instance() {
 }
 
 GameDataContainer::GameDataContainer(QObject *parent) : QObject(parent) {
+    sharedData = SharedDataService::Instance();
+
     health = 0;
     concentration = 0;
     spirit = 0;
@@ -32,6 +37,8 @@ GameDataContainer::GameDataContainer(QObject *parent) : QObject(parent) {
 
     rt = 0;
     ct = 0;
+
+    roomId = 0;
 }
 
 QStringList GameDataContainer::extractExp(QString exp, bool brief) {        
@@ -69,6 +76,9 @@ void GameDataContainer::setExpField(bool brief, QString name, QString exp) {
     if(this->expMap.value(name.toLower()).value("state") > state) {
         QWriteLocker locker(&lock);
         expGain.insert(name, QDateTime::currentMSecsSinceEpoch());
+        locker.unlock();
+
+        emit changed("EXP_PULSE", name);
     }
 }
 
@@ -105,6 +115,7 @@ void GameDataContainer::setExpFieldBrief(QString name, QString exp) {
 void GameDataContainer::setCharName(QString charName) {
     QWriteLocker locker(&lock);
     this->charName = charName;
+    sharedData->setString(SHARED_CHAR_NAME, charName);
 }
 
 QString GameDataContainer::getCharName() {
@@ -146,9 +157,13 @@ QMap<QString, int> GameDataContainer::getExp(QString name) {
     QMap<QString, QMap<QString, int> > exp = this->expMap;
     lock.unlock();
 
+    return findExp(exp, name);
+}
+
+QMap<QString, int> GameDataContainer::findExp(const QMap<QString, QMap<QString, int> >& exp, QString name) {
     QMap<QString, int> expValueMap;
 
-    QMap<QString, QMap<QString, int> >::iterator find = exp.find(name);
+    QMap<QString, QMap<QString, int> >::const_iterator find = exp.find(name);
     if(find != exp.end()) {
         expValueMap = find.value();
     } else {
@@ -182,6 +197,7 @@ QStringList GameDataContainer::getContainer() {
 void GameDataContainer::setRoomName(QString name) {
     QWriteLocker locker(&lock);
     this->roomName = name;
+    sharedData->setString(SHARED_ROOM_TITLE, name);
 }
 
 QString GameDataContainer::getRoomName() {
@@ -248,6 +264,7 @@ QString GameDataContainer::getRoomPlayers() {
 void GameDataContainer::setRoomExits(QString exits) {
     QWriteLocker locker(&lock);
     this->roomExits = exits;
+    sharedData->setString(SHARED_ROOM_EXITS, exits);
 }
 
 QString GameDataContainer::getRoomExits() {
@@ -278,6 +295,7 @@ QList<QString> GameDataContainer::getCompassDirections() {
 void GameDataContainer::setRight(QString right) {
     QWriteLocker locker(&lock);
     this->wieldRight = right;
+    sharedData->setString(SHARED_WIELD_RIGHT, right);
 }
 
 QString GameDataContainer::getRight() {
@@ -288,6 +306,7 @@ QString GameDataContainer::getRight() {
 void GameDataContainer::setRightNoun(QString rightNoun) {
     QWriteLocker locker(&lock);
     this->wieldRightNoun = rightNoun;
+    sharedData->setString(SHARED_WIELD_RIGHT_NOUN, rightNoun);
 }
 
 QString GameDataContainer::getRightNoun() {
@@ -298,6 +317,7 @@ QString GameDataContainer::getRightNoun() {
 void GameDataContainer::setLeft(QString left) {
     QWriteLocker locker(&lock);
     this->wieldLeft = left;
+    sharedData->setString(SHARED_WIELD_LEFT, left);
 }
 
 QString GameDataContainer::getLeft() {
@@ -308,6 +328,7 @@ QString GameDataContainer::getLeft() {
 void GameDataContainer::setLeftNoun(QString leftNoun) {
     QWriteLocker locker(&lock);
     this->wieldLeftNoun = leftNoun;
+    sharedData->setString(SHARED_WIELD_LEFT_NOUN, leftNoun);
 }
 
 QString GameDataContainer::getLeftNoun() {
@@ -317,7 +338,12 @@ QString GameDataContainer::getLeftNoun() {
 
 void GameDataContainer::setStanding(bool standing) {
     QWriteLocker locker(&lock);
+    if(this->standing == standing) return;
     this->standing = standing;
+    sharedData->setFlag(SHARED_STANDING, standing);
+    locker.unlock();
+
+    emit changed("STANDING", standing);
 }
 
 bool GameDataContainer::getStanding() {
@@ -327,7 +353,12 @@ bool GameDataContainer::getStanding() {
 
 void GameDataContainer::setSitting(bool sitting) {
     QWriteLocker locker(&lock);
+    if(this->sitting == sitting) return;
     this->sitting = sitting;
+    sharedData->setFlag(SHARED_SITTING, sitting);
+    locker.unlock();
+
+    emit changed("SITTING", sitting);
 }
 
 bool GameDataContainer::getSitting() {
@@ -337,7 +368,12 @@ bool GameDataContainer::getSitting() {
 
 void GameDataContainer::setKneeling(bool kneeling) {
     QWriteLocker locker(&lock);
+    if(this->kneeling == kneeling) return;
     this->kneeling = kneeling;
+    sharedData->setFlag(SHARED_KNEELING, kneeling);
+    locker.unlock();
+
+    emit changed("KNEELING", kneeling);
 }
 
 bool GameDataContainer::getKneeling() {
@@ -347,7 +383,12 @@ bool GameDataContainer::getKneeling() {
 
 void GameDataContainer::setProne(bool prone) {
     QWriteLocker locker(&lock);
+    if(this->prone == prone) return;
     this->prone = prone;
+    sharedData->setFlag(SHARED_PRONE, prone);
+    locker.unlock();
+
+    emit changed("PRONE", prone);
 }
 
 bool GameDataContainer::getProne() {
@@ -357,7 +398,12 @@ bool GameDataContainer::getProne() {
 
 void GameDataContainer::setStunned(bool stunned) {
     QWriteLocker locker(&lock);
+    if(this->stunned == stunned) return;
     this->stunned = stunned;
+    sharedData->setFlag(SHARED_STUNNED, stunned);
+    locker.unlock();
+
+    emit changed("STUNNED", stunned);
 }
 
 bool GameDataContainer::getStunned() {
@@ -367,7 +413,12 @@ bool GameDataContainer::getStunned() {
 
 void GameDataContainer::setBleeding(bool bleeding) {
     QWriteLocker locker(&lock);
+    if(this->bleeding == bleeding) return;
     this->bleeding = bleeding;
+    sharedData->setFlag(SHARED_BLEEDING, bleeding);
+    locker.unlock();
+
+    emit changed("BLEEDING", bleeding);
 }
 
 bool GameDataContainer::getBleeding() {
@@ -377,7 +428,12 @@ bool GameDataContainer::getBleeding() {
 
 void GameDataContainer::setHidden(bool hidden) {
     QWriteLocker locker(&lock);
+    if(this->hidden == hidden) return;
     this->hidden = hidden;
+    sharedData->setFlag(SHARED_HIDDEN, hidden);
+    locker.unlock();
+
+    emit changed("HIDDEN", hidden);
 }
 
 bool GameDataContainer::getHidden() {
@@ -387,7 +443,12 @@ bool GameDataContainer::getHidden() {
 
 void GameDataContainer::setInvisible(bool invisible) {
     QWriteLocker locker(&lock);
+    if(this->invisible == invisible) return;
     this->invisible = invisible;
+    sharedData->setFlag(SHARED_INVISIBLE, invisible);
+    locker.unlock();
+
+    emit changed("INVISIBLE", invisible);
 }
 
 bool GameDataContainer::getInvisible() {
@@ -397,7 +458,12 @@ bool GameDataContainer::getInvisible() {
 
 void GameDataContainer::setWebbed(bool webbed) {
     QWriteLocker locker(&lock);
+    if(this->webbed == webbed) return;
     this->webbed = webbed;
+    sharedData->setFlag(SHARED_WEBBED, webbed);
+    locker.unlock();
+
+    emit changed("WEBBED", webbed);
 }
 
 bool GameDataContainer::getWebbed() {
@@ -407,7 +473,12 @@ bool GameDataContainer::getWebbed() {
 
 void GameDataContainer::setJoined(bool joined) {
     QWriteLocker locker(&lock);
+    if(this->joined == joined) return;
     this->joined = joined;
+    sharedData->setFlag(SHARED_JOINED, joined);
+    locker.unlock();
+
+    emit changed("JOINED", joined);
 }
 
 bool GameDataContainer::getJoined() {
@@ -417,7 +488,12 @@ bool GameDataContainer::getJoined() {
 
 void GameDataContainer::setDead(bool dead) {
     QWriteLocker locker(&lock);
+    if(this->dead == dead) return;
     this->dead = dead;
+    sharedData->setFlag(SHARED_DEAD, dead);
+    locker.unlock();
+
+    emit changed("DEAD", dead);
 }
 
 bool GameDataContainer::getDead() {
@@ -427,7 +503,12 @@ bool GameDataContainer::getDead() {
 
 void GameDataContainer::setHealth(int health) {
     QWriteLocker locker(&lock);
+    if(this->health == health) return;
     this->health = health;
+    sharedData->setInt(SHARED_HEALTH, health);
+    locker.unlock();
+
+    emit changed("HEALTH", health);
 }
 
 int GameDataContainer::getHealth() {
@@ -437,7 +518,12 @@ int GameDataContainer::getHealth() {
 
 void GameDataContainer::setConcentration(int concentration) {
     QWriteLocker locker(&lock);
+    if(this->concentration == concentration) return;
     this->concentration = concentration;
+    sharedData->setInt(SHARED_CONCENTRATION, concentration);
+    locker.unlock();
+
+    emit changed("CONCENTRATION", concentration);
 }
 
 int GameDataContainer::getConcentration() {
@@ -447,7 +533,12 @@ int GameDataContainer::getConcentration() {
 
 void GameDataContainer::setSpirit(int spirit) {
     QWriteLocker locker(&lock);
+    if(this->spirit == spirit) return;
     this->spirit = spirit;
+    sharedData->setInt(SHARED_SPIRIT, spirit);
+    locker.unlock();
+
+    emit changed("SPIRIT", spirit);
 }
 
 int GameDataContainer::getSpirit() {
@@ -457,7 +548,12 @@ int GameDataContainer::getSpirit() {
 
 void GameDataContainer::setMana(int mana) {
     QWriteLocker locker(&lock);
+    if(this->mana == mana) return;
     this->mana = mana;
+    sharedData->setInt(SHARED_MANA, mana);
+    locker.unlock();
+
+    emit changed("MANA", mana);
 }
 
 int GameDataContainer::getMana() {
@@ -468,7 +564,12 @@ int GameDataContainer::getMana() {
 void GameDataContainer::setFatigue(int fatigue) {
 
     QWriteLocker locker(&lock);
+    if(this->fatigue == fatigue) return;
     this->fatigue = fatigue;
+    sharedData->setInt(SHARED_FATIGUE, fatigue);
+    locker.unlock();
+
+    emit changed("FATIGUE", fatigue);
 }
 
 int GameDataContainer::getFatigue() {
@@ -479,13 +580,23 @@ int GameDataContainer::getFatigue() {
 void GameDataContainer::setRt(int rt) {
     if(rt < 0) rt = 0;
     QWriteLocker locker(&lock);
+    if(this->rt == rt) return;
     this->rt = rt;
+    sharedData->setInt(SHARED_RT, rt);
+    locker.unlock();
+
+    emit changed("RT", rt);
 }
 
 void GameDataContainer::setCt(int ct) {
     if(ct < 0) ct = 0;
     QWriteLocker locker(&lock);
+    if(this->ct == ct) return;
     this->ct = ct;
+    sharedData->setInt(SHARED_CT, ct);
+    locker.unlock();
+
+    emit changed("CT", ct);
 }
 
 int GameDataContainer::getRt() {
@@ -500,7 +611,11 @@ int GameDataContainer::getCt() {
 
 void GameDataContainer::setActiveSpells(QStringList activeSpells) {
     QWriteLocker locker(&lock);
+    if(this->activeSpells == activeSpells) return;
     this->activeSpells = activeSpells;
+    locker.unlock();
+
+    emit changed("ACTIVE_SPELLS", activeSpells);
 }
 
 QStringList GameDataContainer::getActiveSpells() {
@@ -518,6 +633,21 @@ void GameDataContainer::clearActiveSpells() {
     this->activeSpells.clear();
 }
 
+void GameDataContainer::setRoomId(int roomId) {
+    QWriteLocker locker(&lock);
+    if(this->roomId == roomId) return;
+    this->roomId = roomId;
+    sharedData->setInt(SHARED_ROOM_ID, roomId);
+    locker.unlock();
+
+    emit changed("ROOM_ID", roomId);
+}
+
+int GameDataContainer::getRoomId() {
+    QReadLocker locker(&lock);
+    return this->roomId;
+}
+
 QList<QString> GameDataContainer::getDirections() {
     QReadLocker locker(&lock);
     return this->directions;
@@ -527,3 +657,68 @@ void GameDataContainer::setDirections(QList<QString> directions) {
     QWriteLocker locker(&lock);
     this->directions = directions;
 }
+
+/* reads all requested fields under a single lock so scripts get a consistent view */
+QVariantMap GameDataContainer::snapshot(const QStringList& fields) {
+    QReadLocker locker(&lock);
+
+    QVariantMap values;
+    foreach(const QString& field, fields) {
+        int index = field.indexOf("?");
+        QString name = index > -1 ? field.left(index) : field;
+        QString arg = index > -1 ? field.mid(index + 1) : QString();
+        values.insert(field, this->field(name, arg));
+    }
+    return values;
+}
+
+QVariant GameDataContainer::get(const QString& field) {
+    return this->snapshot(QStringList() << field).value(field);
+}
+
+/* caller holds the lock */
+QVariant GameDataContainer::field(const QString& name, const QString& arg) {
+    typedef std::function<QVariant(const GameDataContainer*, const QString&)> FieldReader;
+    static const QHash<QString, FieldReader> readers {
+        {"CHAR_NAME", [](const GameDataContainer* d, const QString&) { return QVariant(d->charName); }},
+        {"EXP_RANK", [](const GameDataContainer* d, const QString& arg) { return QVariant(findExp(d->expMap, arg.toLower()).value("rank")); }},
+        {"EXP_STATE", [](const GameDataContainer* d, const QString& arg) { return QVariant(findExp(d->expMap, arg.toLower()).value("state")); }},
+        {"EXP_NAMES", [](const GameDataContainer* d, const QString&) { return QVariant(QStringList(d->exp.keys())); }},
+        {"ACTIVE_SPELLS", [](const GameDataContainer* d, const QString&) { return QVariant(d->activeSpells); }},
+        {"INVENTORY", [](const GameDataContainer* d, const QString&) { return QVariant(d->inventory); }},
+        {"CONTAINER", [](const GameDataContainer* d, const QString&) { return QVariant(d->container); }},
+        {"WIELD_RIGHT", [](const GameDataContainer* d, const QString&) { return QVariant(d->wieldRight); }},
+        {"WIELD_RIGHT_NOUN", [](const GameDataContainer* d, const QString&) { return QVariant(d->wieldRightNoun); }},
+        {"WIELD_LEFT", [](const GameDataContainer* d, const QString&) { return QVariant(d->wieldLeft); }},
+        {"WIELD_LEFT_NOUN", [](const GameDataContainer* d, const QString&) { return QVariant(d->wieldLeftNoun); }},
+        {"HEALTH", [](const GameDataContainer* d, const QString&) { return QVariant(d->health); }},
+        {"CONCENTRATION", [](const GameDataContainer* d, const QString&) { return QVariant(d->concentration); }},
+        {"SPIRIT", [](const GameDataContainer* d, const QString&) { return QVariant(d->spirit); }},
+        {"FATIGUE", [](const GameDataContainer* d, const QString&) { return QVariant(d->fatigue); }},
+        {"STANDING", [](const GameDataContainer* d, const QString&) { return QVariant(d->standing); }},
+        {"SITTING", [](const GameDataContainer* d, const QString&) { return QVariant(d->sitting); }},
+        {"KNEELING", [](const GameDataContainer* d, const QString&) { return QVariant(d->kneeling); }},
+        {"PRONE", [](const GameDataContainer* d, const QString&) { return QVariant(d->prone); }},
+        {"STUNNED", [](const GameDataContainer* d, const QString&) { return QVariant(d->stunned); }},
+        {"BLEEDING", [](const GameDataContainer* d, const QString&) { return QVariant(d->bleeding); }},
+        {"HIDDEN", [](const GameDataContainer* d, const QString&) { return QVariant(d->hidden); }},
+        {"INVISIBLE", [](const GameDataContainer* d, const QString&) { return QVariant(d->invisible); }},
+        {"WEBBED", [](const GameDataContainer* d, const QString&) { return QVariant(d->webbed); }},
+        {"JOINED", [](const GameDataContainer* d, const QString&) { return QVariant(d->joined); }},
+        {"DEAD", [](const GameDataContainer* d, const QString&) { return QVariant(d->dead); }},
+        {"ROOM_TITLE", [](const GameDataContainer* d, const QString&) { return QVariant(d->roomName); }},
+        {"ROOM_DESC", [](const GameDataContainer* d, const QString&) { return QVariant(d->roomDesc); }},
+        {"ROOM_OBJECTS", [](const GameDataContainer* d, const QString&) { return QVariant(d->roomObjs); }},
+        {"ROOM_PLAYERS", [](const GameDataContainer* d, const QString&) { return QVariant(d->roomPlayers); }},
+        {"ROOM_EXITS", [](const GameDataContainer* d, const QString&) { return QVariant(d->roomExits); }},
+        {"ROOM_MONSTERS_BOLD", [](const GameDataContainer* d, const QString&) { return QVariant(d->roomMonstersBold); }},
+        {"RT", [](const GameDataContainer* d, const QString&) { return QVariant(d->rt); }},
+        {"CT", [](const GameDataContainer* d, const QString&) { return QVariant(d->ct); }},
+        {"MANA", [](const GameDataContainer* d, const QString&) { return QVariant(d->mana); }},
+        {"ROOM_ID", [](const GameDataContainer* d, const QString&) { return QVariant(d->roomId); }}
+    };
+
+    QHash<QString, FieldReader>::const_iterator reader = readers.constFind(name);
+    if(reader == readers.constEnd()) return QVariant();
+    return reader.value()(this, arg);
+}
@@ -6,8 +6,10 @@
 #include <QReadLocker>
 #include <QTime>
 #include <QRegularExpression>
+#include <QVariantMap>
 
 class TextUtils;
+class SharedDataService;
 
 class GameDataContainer : public QObject {
     Q_OBJECT
@@ -126,16 +128,22 @@ public:
     void addActiveSpells(QString activeSpell);
     void clearActiveSpells();
 
+    void setRoomId(int roomId);
+    int getRoomId();
+
     QList<QString> getDirections();
     void setDirections(QList<QString> directions);
 
+    QVariantMap snapshot(const QStringList& fields);
+    QVariant get(const QString& field);
+
 private:
     GameDataContainer(QObject *parent = 0);
     GameDataContainer(GameDataContainer const& copy);
     GameDataContainer& operator = (GameDataContainer const& copy);
     static GameDataContainer* m_pInstance;
 
-    //SharedDataService* sharedDataService;
+    SharedDataService* sharedData;
     QHash<QString, QString> exp;
     QMap<QString, QMap<QString, int> > expMap;
     QMap<QString, qint64> expGain;
@@ -143,6 +151,8 @@ private:
     QStringList inventory;
 
     QStringList extractExp(QString, bool brief);
+    static QMap<QString, int> findExp(const QMap<QString, QMap<QString, int> >& exp, QString name);
+    QVariant field(const QString& name, const QString& arg);
     QReadWriteLock lock;
 
     QString charName;
@@ -184,12 +194,16 @@ private:
     int rt;
     int ct;
 
+    int roomId;
+
     QStringList activeSpells;
 
     QList<QString> directions;
 
 signals:
-    
+    /* emitted after a watched field changes, outside of the lock */
+    void changed(QString field, QVariant value);
+
 public slots:
     
 };
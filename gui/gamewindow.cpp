@@ -2,6 +2,8 @@
 
 #include <QDesktopServices>
 #include <QToolTip>
+#include <QScrollBar>
+#include <QAbstractTextDocumentLayout>
 
 #include "mainwindow.h"
 #include "windowfacade.h"
@@ -37,6 +39,12 @@ GameWindow::GameWindow(QWidget *parent) : QPlainTextEdit(parent) {
 
     connect(this, SIGNAL(copyAvailable(bool)), this, SLOT(enableCopy(bool)));
 
+    // link rects are only valid for the current viewport and layout
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(invalidateLinks()));
+    connect(horizontalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(invalidateLinks()));
+    connect(document(), SIGNAL(contentsChanged()), this, SLOT(invalidateLinks()));
+    connect(document()->documentLayout(), SIGNAL(documentSizeChanged(QSizeF)), this, SLOT(invalidateLinks()));
+
     /* workaround for bottom margin */
     setViewportMargins(0, 0, 0, -6);
 }
@@ -207,6 +215,34 @@ void GameWindow::contextMenuEvent(QContextMenuEvent *event) {
 void GameWindow::resizeEvent(QResizeEvent *event) {
     windowFacade->gameWindowResizeEvent(this);
     QPlainTextEdit::resizeEvent(event);
+    linkIndex.invalidate();
+}
+
+void GameWindow::invalidateLinks() {
+    linkIndex.invalidate();
+}
+
+void GameWindow::rebuildLinkIndex() {
+    linkIndex.clear();
+
+    QPointF offset = contentOffset();
+    int height = viewport()->height();
+
+    QTextBlock block = firstVisibleBlock();
+    while(block.isValid()) {
+        QRectF geometry = blockBoundingGeometry(block).translated(offset);
+        if(geometry.top() > height) break;
+        if(block.isVisible()) {
+            linkIndex.addBlock(block, geometry.topLeft());
+        }
+        block = block.next();
+    }
+    linkIndex.finish();
+}
+
+QString GameWindow::linkAt(const QPoint& pos) {
+    if(!linkIndex.isValid()) this->rebuildLinkIndex();
+    return linkIndex.anchorAt(pos);
 }
 
 void GameWindow::mouseDoubleClickEvent(QMouseEvent* e) {
@@ -220,7 +256,7 @@ void GameWindow::mouseDoubleClickEvent(QMouseEvent* e) {
 
 void GameWindow::mousePressEvent(QMouseEvent *e) {
     if(linksEnabled) {
-        auto anchor = anchorAt(e->pos());
+        auto anchor = linkAt(e->pos());
         if (e->button() == Qt::LeftButton && !anchor.isEmpty()) {
             clickedAnchor = anchor;
             // Here we do not call QPlainTextEdit::mousePressEvent(e);
@@ -234,7 +270,7 @@ void GameWindow::mousePressEvent(QMouseEvent *e) {
 
 void GameWindow::mouseReleaseEvent(QMouseEvent *e) {
     if (linksEnabled && e->button() == Qt::LeftButton && !clickedAnchor.isEmpty()) {
-        if (anchorAt(e->pos()) == clickedAnchor) {
+        if (linkAt(e->pos()) == clickedAnchor) {
             this->resetWindow();
             QDesktopServices::openUrl(QUrl(clickedAnchor, QUrl::TolerantMode));
         }
@@ -253,10 +289,9 @@ void GameWindow::resetWindow() {
 
 void GameWindow::mouseMoveEvent(QMouseEvent *e) {
     if(linksEnabled) {
-        if(!anchorAt(e->pos()).isEmpty()) {
-            viewport()->setCursor(Qt::PointingHandCursor);
-        } else {
-            viewport()->setCursor(Qt::IBeamCursor);
+        Qt::CursorShape shape = linkAt(e->pos()).isEmpty() ? Qt::IBeamCursor : Qt::PointingHandCursor;
+        if(viewport()->cursor().shape() != shape) {
+            viewport()->setCursor(shape);
         }
     }
     QPlainTextEdit::mouseMoveEvent(e);
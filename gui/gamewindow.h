@@ -7,6 +7,7 @@
 
 #include "session.h"
 #include "windowinterface.h"
+#include "linkindex.h"
 
 class MainWindow;
 class WindowFacade;
@@ -48,6 +49,9 @@ private:
     
     void resetWindow();
 
+    QString linkAt(const QPoint& pos);
+    void rebuildLinkIndex();
+
     void loadSettings();
     void buildContextMenu();
 
@@ -78,6 +82,8 @@ private:
 
     QString clickedAnchor;
 
+    LinkIndex linkIndex;
+
     bool linksEnabled;
 
     struct DictionaryEvent {
@@ -100,6 +106,7 @@ private slots:
     void changeAppearance();
     void translationFinished(QString word, QString translation);
     void translationFailed(QString reason);
+    void invalidateLinks();
 
 public slots:
 
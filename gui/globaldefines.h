@@ -4,6 +4,10 @@
 #define GAME_WINDOW_LIMIT 5000
 
 #define MAP_TOP_MARGIN 20
+// recent shortest paths kept per zone
+#define MAP_PATH_CACHE_SIZE 256
+// graphics items kept in built map scenes before old zones are dropped
+#define MAP_SCENE_ITEM_BUDGET 60000
 
 #define WINDOW_SELECT_ALL "All"
 
@@ -0,0 +1,35 @@
+#include "griddelegate.h"
+
+#include <QPainter>
+#include <QtMath>
+
+#include "gridmodel.h"
+
+GridDelegate::GridDelegate(GridModel* model, QObject *parent) : QStyledItemDelegate(parent) {
+    this->model = model;
+}
+
+void GridDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QColor text = option.palette.color(QPalette::Text);
+    QColor background = option.palette.color(QPalette::Base);
+
+    // tracked rows are drawn with inverted colors
+    if(model->isTracked(index.row())) {
+        qSwap(text, background);
+    }
+
+    painter->save();
+    painter->fillRect(option.rect, background);
+    painter->setPen(text);
+    painter->setFont(option.font);
+
+    const QStaticText& staticText = model->staticText(index.row());
+    int y = option.rect.top() + (option.rect.height() - option.fontMetrics.height()) / 2;
+    painter->drawStaticText(QPoint(option.rect.left(), y), staticText);
+    painter->restore();
+}
+
+QSize GridDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    const QStaticText& staticText = model->staticText(index.row());
+    return QSize(qCeil(staticText.size().width()), option.fontMetrics.height() + 2);
+}
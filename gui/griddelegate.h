@@ -0,0 +1,21 @@
+#ifndef GRIDDELEGATE_H
+#define GRIDDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+class GridModel;
+
+class GridDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit GridDelegate(GridModel* model, QObject *parent = 0);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    GridModel* model;
+};
+
+#endif // GRIDDELEGATE_H
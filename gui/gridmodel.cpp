@@ -0,0 +1,121 @@
+#include "gridmodel.h"
+
+GridModel::GridModel(QObject *parent) : QAbstractTableModel(parent) {
+}
+
+int GridModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int GridModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : 1;
+}
+
+QVariant GridModel::data(const QModelIndex &index, int role) const {
+    if(!index.isValid() || index.row() >= rows.size()) return QVariant();
+
+    const GridRow& row = rows.at(index.row());
+    if(role == Qt::DisplayRole) {
+        return row.value;
+    } else if(role == Qt::UserRole) {
+        return row.name;
+    }
+    return QVariant();
+}
+
+int GridModel::lowerBound(const QString& name) const {
+    // rows are kept sorted by name
+    int low = 0, high = rows.size();
+    while(low < high) {
+        int mid = (low + high) / 2;
+        if(rows.at(mid).name < name) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+int GridModel::indexOf(const QString& name) const {
+    int row = this->lowerBound(name);
+    if(row < rows.size() && rows.at(row).name == name) {
+        return row;
+    }
+    return -1;
+}
+
+QString GridModel::name(int row) const {
+    return rows.at(row).name;
+}
+
+QString GridModel::value(int row) const {
+    return rows.at(row).value;
+}
+
+bool GridModel::isTracked(int row) const {
+    return rows.at(row).tracked;
+}
+
+const QStaticText& GridModel::staticText(int row) const {
+    return rows.at(row).text;
+}
+
+void GridModel::setItem(const QString& name, const QString& value, const QString& text) {
+    int row = this->lowerBound(name);
+    if(row < rows.size() && rows.at(row).name == name) {
+        GridRow& gridRow = rows[row];
+        gridRow.value = value;
+        if(gridRow.text.text() == text) return;
+
+        gridRow.text.setText(text);
+        QModelIndex changed = this->index(row, 0);
+        emit dataChanged(changed, changed);
+    } else {
+        GridRow gridRow;
+        gridRow.name = name;
+        gridRow.value = value;
+        gridRow.text.setTextFormat(Qt::RichText);
+        gridRow.text.setText(text);
+        gridRow.tracked = this->matchTracked(name);
+
+        beginInsertRows(QModelIndex(), row, row);
+        rows.insert(row, gridRow);
+        endInsertRows();
+    }
+}
+
+void GridModel::removeItem(const QString& name) {
+    int row = this->indexOf(name);
+    if(row == -1) return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    rows.removeAt(row);
+    endRemoveRows();
+}
+
+bool GridModel::matchTracked(const QString& name) const {
+    foreach(const QRegExp& rx, trackedPatterns) {
+        if(rx.exactMatch(name)) return true;
+    }
+    return false;
+}
+
+void GridModel::setTracked(const QStringList& patterns) {
+    trackedPatterns.clear();
+    foreach(const QString& pattern, patterns) {
+        trackedPatterns << QRegExp(pattern, Qt::CaseInsensitive);
+    }
+
+    for(int i = 0; i < rows.size(); i++) {
+        bool tracked = this->matchTracked(rows.at(i).name);
+        if(rows.at(i).tracked != tracked) {
+            rows[i].tracked = tracked;
+            QModelIndex changed = this->index(i, 0);
+            emit dataChanged(changed, changed);
+        }
+    }
+}
+
+GridModel::~GridModel() {
+}
@@ -0,0 +1,45 @@
+#ifndef GRIDMODEL_H
+#define GRIDMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStaticText>
+#include <QStringList>
+#include <QRegExp>
+
+struct GridRow {
+    QString name;
+    QString value;
+    QStaticText text;
+    bool tracked;
+};
+
+class GridModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit GridModel(QObject *parent = 0);
+    ~GridModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    int indexOf(const QString& name) const;
+    QString name(int row) const;
+    QString value(int row) const;
+    bool isTracked(int row) const;
+    const QStaticText& staticText(int row) const;
+
+    void setItem(const QString& name, const QString& value, const QString& text);
+    void removeItem(const QString& name);
+    void setTracked(const QStringList& patterns);
+
+private:
+    QList<GridRow> rows;
+    QList<QRegExp> trackedPatterns;
+
+    int lowerBound(const QString& name) const;
+    bool matchTracked(const QString& name) const;
+};
+
+#endif // GRIDMODEL_H
@@ -8,20 +8,26 @@
 #include "custom/contextmenu.h"
 #include "generalsettings.h"
 #include "defaultvalues.h"
+#include "gridmodel.h"
+#include "griddelegate.h"
 
-
-GridWindow::GridWindow(QString title, QWidget *parent) : QTableWidget(parent) {
+GridWindow::GridWindow(QString title, QWidget *parent) : QTableView(parent) {
     mainWindow = (MainWindow*)parent;
     settings = GeneralSettings::getInstance();
     wm = mainWindow->getWindowFacade();
 
     this->windowId = title.simplified().remove(' ') + "Window";
 
+    model = new GridModel(this);
+    this->setModel(model);
+    this->setItemDelegate(new GridDelegate(model, this));
+    this->setSelectionMode(QAbstractItemView::NoSelection);
+
     this->buildContextMenu();
     this->loadSettings();
     this->updateSize();
 
-    connect(this, SIGNAL(cellDoubleClicked(int, int)), this, SLOT(addRemoveTracked(int, int)));
+    connect(this, SIGNAL(doubleClicked(const QModelIndex&)), this, SLOT(addRemoveTracked(const QModelIndex&)));
     connect(mainWindow->getWindowFacade(), SIGNAL(updateWindowSettings()), this, SLOT(updateSettings()));
 
     this->setFocusPolicy(Qt::NoFocus);
@@ -59,6 +65,36 @@ void GridWindow::loadSettings() {
 
     textColor = settings->dockWindowFontColor();
     backgroundColor = settings->dockWindowBackground();
+    this->updateColors();
+}
+
+void GridWindow::updateColors() {
+    QPalette p = this->palette();
+    p.setColor(QPalette::Text, textColor);
+    p.setColor(QPalette::Base, backgroundColor);
+    this->setPalette(p);
+    this->viewport()->setPalette(p);
+}
+
+void GridWindow::setTextColor(QColor color) {
+    textColor = color;
+    this->updateColors();
+}
+
+void GridWindow::setBackgroundColor(QColor color) {
+    backgroundColor = color;
+    this->updateColors();
+}
+
+void GridWindow::setGridFont(QFont font) {
+    gridFont = font;
+    gridFont.setStyleStrategy(QFont::PreferAntialias);
+    this->setFont(gridFont);
+    this->updateSize();
+}
+
+GridModel* GridWindow::getModel() {
+    return model;
 }
 
 void GridWindow::updateSize() {
@@ -76,87 +112,31 @@ QColor GridWindow::getTextColor() {
     return viewport()->palette().color(QPalette::Text);
 }
 
-QLabel* GridWindow::gridValueLabel(QWidget* parent) {
-    QLabel* label = new QLabel(parent);    
-    label->setFont(gridFont);
-
-    QPalette p = label->palette();
-    p.setColor(QPalette::Text, textColor);
-    p.setColor(QPalette::Base, backgroundColor);
-    label->setPalette(p);
-
-    label->setTextFormat(Qt::RichText);
-    label->setAutoFillBackground(true);
-    label->setProperty("tracked", 0);   
-    return label;
-}
-
-void GridWindow::invertColors(QWidget* widget) {
-    QPalette p = widget->palette();
-    QRgb rgbText = p.color(QPalette::Text).rgba()^0xffffff;
-    QRgb rgbBase = p.color(QPalette::Base).rgba()^0xffffff;
-
-    p.setColor(QPalette::Text, QColor(rgbText));
-    p.setColor(QPalette::Base, QColor(rgbBase));
-
-    widget->setPalette(p);
-}
-
-void GridWindow::setItemColors(QWidget* widget, QColor text, QColor background) {
-    QPalette p = widget->palette();
-    p.setColor(QPalette::Text, text);
-    p.setColor(QPalette::Base, background);
-    widget->setPalette(p);
-}
-
 void GridWindow::track(QString skillName) {
     if(!tracked.contains(skillName))
         tracked << skillName;
 
-    int rows = this->rowCount();
-
-    QRegExp rx(skillName);
-    rx.setCaseSensitivity(Qt::CaseInsensitive);
-
-    for(int i = 0; i < rows; i++) {
-        QWidget* widget = this->cellWidget(i, 0);
-        if(widget != NULL) {
-            if(rx.exactMatch(widget->objectName())) track(skillName, widget);
-        }
-    }
+    model->setTracked(tracked);
 }
 
-void GridWindow::track(QString skillName, QWidget* widget) {
-    if(tracked.contains(skillName)) {
-        if(widget->property("tracked") == 0) {
-            this->setItemColors(widget, backgroundColor, textColor);
-            widget->setProperty("tracked", 1);
-        }
-    } else {
-        if(widget->property("tracked") == 1) {
-            this->setItemColors(widget, textColor, backgroundColor);
-            widget->setProperty("tracked", 0);
+void GridWindow::addRemoveTracked(const QModelIndex& index) {
+    QString name = model->name(index.row());
+    if(model->isTracked(index.row())) {
+        QRegExp rx;
+        rx.setCaseSensitivity(Qt::CaseInsensitive);
+        foreach(QString pattern, tracked) {
+            rx.setPattern(pattern);
+            if(rx.exactMatch(name)) tracked.removeAll(pattern);
         }
-    }
-}
-
-void GridWindow::addRemoveTracked(int row, int col) {
-    QWidget* w = this->cellWidget(row, col);
-    if(!tracked.contains(w->objectName())) {
-        tracked << w->objectName();
     } else {
-        tracked.removeAll(w->objectName());
+        tracked << name;
     }
-    this->track(w->objectName(), w);
+    model->setTracked(tracked);
 }
 
 void GridWindow::clearTracked() {
-    tracked.clear();    
-    for (int i = 0; i < this->rowCount(); ++i) {
-        QWidget* w = this->cellWidget(i, 0);
-        this->setItemColors(w, textColor, backgroundColor);
-        w->setProperty("tracked", 0);
-    }
+    tracked.clear();
+    model->setTracked(tracked);
 }
 
 void GridWindow::contextMenuEvent(QContextMenuEvent* event) {
@@ -217,12 +197,7 @@ void GridWindow::clearFont() {
 }
 
 void GridWindow::updateFont() {
-    for(int i = 0; i < this->rowCount(); i++) {
-        QWidget* widget = this->cellWidget(i, 0);
-        if(widget != NULL) {
-            ((QLabel*)widget)->setFont(gridFont);
-        }
-    }
+    this->setFont(gridFont);
     this->updateSize();
 }
 
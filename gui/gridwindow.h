@@ -1,16 +1,16 @@
 #ifndef GRIDWINDOW_H
 #define GRIDWINDOW_H
 
-#include <QTableWidget>
+#include <QTableView>
 #include <QDockWidget>
-#include <QLabel>
 
 class MainWindow;
 class GeneralSettings;
 class WindowFacade;
 class ContextMenu;
+class GridModel;
 
-class GridWindow : public QTableWidget {
+class GridWindow : public QTableView {
     Q_OBJECT
 
 public:
@@ -20,9 +20,11 @@ public:
     QColor getBgColor();
     QColor getTextColor();
 
-    QLabel* gridValueLabel(QWidget* parent);
+    void setTextColor(QColor color);
+    void setBackgroundColor(QColor color);
+    void setGridFont(QFont font);
 
-    void track(QString skillName, QWidget* widget);  
+    GridModel* getModel();
 
     ContextMenu* getMenu();
     void setWindowParameter(QString parameter, QVariant value);
@@ -40,9 +42,10 @@ private:
 
     QString windowId;
 
-    void loadSettings();    
-    void invertColors(QWidget* widget);
-    void setItemColors(QWidget* widget, QColor text, QColor background);
+    GridModel* model;
+
+    void loadSettings();
+    void updateColors();
 
     void contextMenuEvent(QContextMenuEvent* event);
     void buildContextMenu();
@@ -58,7 +61,7 @@ private:
 signals:
 
 public slots:
-    void addRemoveTracked(int, int);
+    void addRemoveTracked(const QModelIndex&);
     void updateSettings();
     void track(QString skillName);
     void clearTracked();
@@ -21,7 +21,7 @@ QPalette GridWindowFactory::palette() {
     return palette;
 }
 
-QTableWidget* GridWindowFactory::tableBox(QString name) {
+GridWindow* GridWindowFactory::tableBox(QString name) {
     QFont font = settings->getParameter("DockWindow/font",
         QFont(DEFAULT_DOCK_FONT, DEFAULT_DOCK_FONT_SIZE)).value<QFont>();
 
@@ -34,11 +34,10 @@ QTableWidget* GridWindowFactory::tableBox(QString name) {
     gridWindow->horizontalHeader()->setVisible(false);
     gridWindow->verticalHeader()->setVisible(false);
     gridWindow->setShowGrid(false);
-    gridWindow->setColumnCount(1);
 
     //gridWindow->setStyleSheet("item { margin: -10px; padding: -10px: border: none; }");
 
-    return (QTableWidget*)gridWindow;
+    return gridWindow;
 }
 
 QDockWidget* GridWindowFactory::createWindow(const char* name) {
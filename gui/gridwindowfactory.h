@@ -2,12 +2,12 @@
 #define GRIDWINDOWFACTORY_H
 
 #include <QObject>
-#include <QTableWidget>
 #include <QDockWidget>
 #include <QHeaderView>
 
 class MainWindow;
 class GeneralSettings;
+class GridWindow;
 
 class GridWindowFactory : public QObject {
     Q_OBJECT
@@ -20,7 +20,7 @@ public:
 
 private:
     QPalette palette();
-    QTableWidget* tableBox(QString);
+    GridWindow* tableBox(QString);
 
     MainWindow* mainWindow;
     GeneralSettings* settings;
@@ -28,10 +28,10 @@ QString GridWriterThread::process(QString text, QString win) {
 void GridWriterThread::onProcess(const GridEntry& gridEntry) {
     if(alter->ignore(gridEntry.text, window->objectName())) return;
 
+    // emit only the changed row; empty text removes it
     if(gridEntry.text.isEmpty()) {
-        highlightedItems.remove(gridEntry.name);
+        emit writeGridItem(gridEntry.name, QString());
     } else {
-        highlightedItems.insert(gridEntry.name, this->process(gridEntry.text, window->objectName()));
+        emit writeGridItem(gridEntry.name, this->process(gridEntry.text, window->objectName()));
     }
-    emit writeGrid(highlightedItems);
 }
@@ -2,7 +2,6 @@
 #define GRIDHIGHLIGHTERTHREAD_H
 
 #include <QString>
-#include <QMap>
 #include "workqueuethread.h"
 
 class Highlighter;
@@ -15,8 +14,6 @@ struct GridEntry {
     QString text;
 };
 
-typedef QMap<QString, QString> GridItems;
-
 class GridWriterThread : public WorkQueueThread<GridEntry> {
     Q_OBJECT
     using Parent = WorkQueueThread<GridEntry>;
@@ -34,7 +31,6 @@ private:
     MainWindow* mainWindow;
     bool append;
     QRegExp rxRemoveTags;
-    QMap<QString, QString> highlightedItems;
 
     GridWindow* window;
 
@@ -46,7 +42,7 @@ public slots:
     void updateSettings();
 
 signals:
-    void writeGrid(GridItems);
+    void writeGridItem(QString, QString);
 
 };
 
@@ -12,7 +12,7 @@ DEFINES += RELEASE_VERSION=\\\"$$RELEASE_VERSION\\\"
     error("Could not find the common.pri file!")
 }
 
-QT       += widgets core gui network xml multimedia concurrent
+QT       += widgets core gui network xml multimedia concurrent qml
 
 include(../log4qt/src/log4qt/log4qt.pri)
 
@@ -31,6 +31,8 @@ include(custom/custom.pri)
 include(audio/audio.pri)
 include(toolbar/toolbar.pri)
 include(dict/dict.pri)
+include(trigger/trigger.pri)
+include(js/js.pri)
 
 APP_NAME = Frostbite
 
@@ -55,6 +57,7 @@ SOURCES += main.cpp\
     eauthservice.cpp \
     script.cpp \
     scriptservice.cpp \
+    scriptcommandqueue.cpp \
     gamedatacontainer.cpp \
     timerbar.cpp \
     macrodialog.cpp \
@@ -87,6 +90,8 @@ SOURCES += main.cpp\
     shareddataservice.cpp \
     gridwindowfactory.cpp \
     gridwindow.cpp \
+    gridmodel.cpp \
+    griddelegate.cpp \
     scriptapiserver.cpp \
     apisettings.cpp \
     authlogger.cpp \
@@ -99,7 +104,11 @@ SOURCES += main.cpp\
     hyperlinkservice.cpp \
     hyperlinkutils.cpp \
     session.cpp \
-    scriptstreamserver.cpp
+    scriptstreamserver.cpp \
+    streamclient.cpp \
+    uiupdatequeue.cpp \
+    pixmapatlas.cpp \
+    linkindex.cpp
 
 HEADERS  += mainwindow.h \
     clientsettings.h \
@@ -113,6 +122,7 @@ HEADERS  += mainwindow.h \
     eauthservice.h \
     script.h \
     scriptservice.h \
+    scriptcommandqueue.h \
     gamedatacontainer.h \
     timerbar.h \
     macrodialog.h \
@@ -149,6 +159,8 @@ HEADERS  += mainwindow.h \
     shareddataservice.h \
     gridwindowfactory.h \
     gridwindow.h \
+    gridmodel.h \
+    griddelegate.h \
     scriptapiserver.h \
     apisettings.h \
     authlogger.h \
@@ -163,7 +175,11 @@ HEADERS  += mainwindow.h \
     concurrentqueue.h \
     workqueuethread.h \
     session.h \
-    scriptstreamserver.h
+    scriptstreamserver.h \
+    streamclient.h \
+    uiupdatequeue.h \
+    pixmapatlas.h \
+    linkindex.h
 
 FORMS    += mainwindow.ui \
     macrodialog.ui \
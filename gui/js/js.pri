@@ -0,0 +1,7 @@
+HEADERS += \
+    $$PWD/jsscript.h \
+    $$PWD/jsscriptapi.h
+
+SOURCES += \
+    $$PWD/jsscript.cpp \
+    $$PWD/jsscriptapi.cpp
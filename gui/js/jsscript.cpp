@@ -0,0 +1,119 @@
+#include "jsscript.h"
+
+#include <QFile>
+#include <QEventLoop>
+#include <QJSEngine>
+#include <QQmlEngine>
+
+#include "js/jsscriptapi.h"
+#include "clientsettings.h"
+#include "defaultvalues.h"
+#include "gamedatacontainer.h"
+
+/* top level helpers so scripts can call put("look") instead of client.put("look") */
+static const char* JS_PRELUDE =
+    "(function(global) {"
+    "  ['put', 'setPriority', 'echo', 'get', 'findPath', 'findRoute', 'currentRoom', 'onLine', 'onPrompt',"
+    "   'waitForRt', 'wait', 'exit'].forEach(function(name) {"
+    "    global[name] = function() { return client[name].apply(client, arguments); };"
+    "  });"
+    "  global.window = {"
+    "    add: function(id, title) { client.addWindow(id, title); },"
+    "    remove: function(id) { client.removeWindow(id); },"
+    "    clear: function(id) { client.clearWindow(id); },"
+    "    write: function(id, text) { client.writeWindow(id, text); }"
+    "  };"
+    "})(this);";
+
+JsScript::JsScript(QString fileName, QStringList args, MapData* mapData, QObject *parent) : QThread(parent) {
+    this->fileName = fileName;
+    this->args = args;
+    this->mapData = mapData;
+    engine = NULL;
+    timer.start();
+}
+
+QString JsScript::currentFileName() {
+    return fileName;
+}
+
+QStringList JsScript::getArgs() {
+    return args;
+}
+
+qint64 JsScript::elapsed() {
+    return timer.elapsed();
+}
+
+bool JsScript::isAborted() {
+    return aborted.load() != 0;
+}
+
+/* called on the gui thread, delivered to the script thread */
+void JsScript::writeText(QByteArray text, bool prompt) {
+    if(this->isRunning()) emit textReceived(QString::fromLocal8Bit(text), prompt);
+}
+
+/* stops a script waiting for events and interrupts one busy in its own code;
+   the thread is never terminated, it could hold locks the client needs */
+void JsScript::abort() {
+    aborted.store(1);
+    emit abortRequested();
+#if JS_SCRIPTS_SUPPORTED
+    QMutexLocker locker(&engineMutex);
+    if(engine != NULL) engine->setInterrupted(true);
+#endif
+}
+
+void JsScript::run() {
+    QString path = ClientSettings::getInstance()->getQStringNotBlank("Script/scriptPath", SCRIPT_PATH) +
+            "/" + fileName + ".js";
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        emit error("Unable to read " + path);
+        return;
+    }
+    QString source = QString::fromUtf8(file.readAll());
+    file.close();
+
+    QJSEngine jsEngine;
+    JsScriptApi api(this, mapData);
+    QQmlEngine::setObjectOwnership(&api, QQmlEngine::CppOwnership);
+
+    QEventLoop loop;
+    connect(&api, SIGNAL(finished()), &loop, SLOT(quit()));
+    connect(this, SIGNAL(textReceived(QString, bool)), &api, SLOT(writeText(QString, bool)));
+    connect(this, SIGNAL(abortRequested()), &api, SLOT(abort()));
+    connect(GameDataContainer::Instance(), SIGNAL(changed(QString, QVariant)),
+            &api, SLOT(stateChanged(QString, QVariant)));
+
+    QMutexLocker locker(&engineMutex);
+    engine = &jsEngine;
+    locker.unlock();
+
+    jsEngine.globalObject().setProperty("client", jsEngine.newQObject(&api));
+    jsEngine.globalObject().setProperty("args", jsEngine.toScriptValue(args));
+    jsEngine.evaluate(JS_PRELUDE);
+
+    if(!this->isAborted()) {
+        QJSValue result = jsEngine.evaluate(source, path);
+        if(result.isError() && !api.isExiting() && !this->isAborted()) {
+            emit error(result.toString() + " at line " + result.property("lineNumber").toString());
+        } else if(api.hasHandlers() && !api.isExiting() && !this->isAborted()) {
+            // the script registered handlers, keep serving events until it exits
+            loop.exec();
+        }
+    }
+    if(!api.getError().isEmpty()) emit error(api.getError());
+
+    locker.relock();
+    engine = NULL;
+}
+
+JsScript::~JsScript() {
+    if(this->isRunning()) {
+        this->abort();
+        this->wait();
+    }
+}
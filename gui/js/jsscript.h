@@ -0,0 +1,65 @@
+#ifndef JSSCRIPT_H
+#define JSSCRIPT_H
+
+#include <QThread>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QMutex>
+
+#include "scriptcommandqueue.h"
+
+/* scripts are stopped through QJSEngine::setInterrupted, never by killing the thread */
+#define JS_SCRIPTS_SUPPORTED (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
+
+class QJSEngine;
+class MapData;
+
+/* A JavaScript file run in process on its own thread. The engine and
+   its bindings are created on that thread; game text reaches them as
+   queued signals and everything the script does towards the gui is
+   emitted back the same way. Commands are queued on the gui thread
+   and sent in turn with those of the other scripts. */
+class JsScript : public QThread, public ScriptCommandQueue {
+    Q_OBJECT
+
+public:
+    JsScript(QString fileName, QStringList args, MapData* mapData, QObject *parent = 0);
+    ~JsScript();
+
+    QString currentFileName();
+    QStringList getArgs();
+    qint64 elapsed();
+    bool isAborted();
+
+    void writeText(QByteArray text, bool prompt);
+    void abort();
+
+protected:
+    void run() override;
+
+private:
+    QString fileName;
+    QStringList args;
+    QElapsedTimer timer;
+    QAtomicInt aborted;
+    MapData* mapData;
+    QJSEngine* engine;
+    QMutex engineMutex;
+
+signals:
+    void textReceived(QString text, bool prompt);
+    void abortRequested();
+
+    void command(QString);
+    void priorityChanged(int);
+    void echo(QString);
+    void error(QString);
+
+    void addWindow(QString id, QString title);
+    void removeWindow(QString id);
+    void clearWindow(QString id);
+    void writeWindow(QString id, QString text);
+};
+
+#endif // JSSCRIPT_H
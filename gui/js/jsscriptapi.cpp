@@ -0,0 +1,192 @@
+#include "jsscriptapi.h"
+
+#include <QEventLoop>
+#include <QTimer>
+#include <QJSEngine>
+
+#include "js/jsscript.h"
+#include "gamedatacontainer.h"
+#include "maps/mapdata.h"
+#include "maps/roomnode.h"
+#include "textutils.h"
+#include "defaultvalues.h"
+
+JsScriptApi::JsScriptApi(JsScript* script, MapData* mapData) : QObject(NULL) {
+    this->script = script;
+    this->mapData = mapData;
+    data = GameDataContainer::Instance();
+
+    waitLoop = NULL;
+    exiting = false;
+    rtPending = false;
+    rxRemoveTags.setPattern("<[^>]*>");
+}
+
+void JsScriptApi::put(QString command) {
+    if(exiting) return;
+    rtPending = true;
+    emit script->command(command);
+}
+
+void JsScriptApi::echo(QString text) {
+    if(!exiting) emit script->echo(text);
+}
+
+/* scripts with a higher priority get their commands sent first */
+void JsScriptApi::setPriority(int priority) {
+    emit script->priorityChanged(priority);
+}
+
+QVariant JsScriptApi::get(QString field) {
+    return data->get(field);
+}
+
+QString JsScriptApi::findPath(QString zone, int from, int to) {
+    return mapData->findPath(zone, from, to);
+}
+
+/* a location note, or a zone id with a room id */
+QString JsScriptApi::findRoute(QString target, int room) {
+    if(room == -1) {
+        RoomNode location = mapData->findLocation(target);
+        return mapData->findRoute(location.getZoneId(), location.getNodeId());
+    }
+    return mapData->findRoute(target, room);
+}
+
+QVariantMap JsScriptApi::currentRoom() {
+    RoomNode room = mapData->getRoom();
+
+    QVariantMap result;
+    result.insert("zone", room.getZoneId());
+    result.insert("level", room.getLevel());
+    result.insert("id", room.getNodeId());
+    return result;
+}
+
+void JsScriptApi::addWindow(QString id, QString title) {
+    emit script->addWindow(id, title);
+}
+
+void JsScriptApi::removeWindow(QString id) {
+    emit script->removeWindow(id);
+}
+
+void JsScriptApi::clearWindow(QString id) {
+    emit script->clearWindow(id);
+}
+
+void JsScriptApi::writeWindow(QString id, QString text) {
+    emit script->writeWindow(id, text);
+}
+
+void JsScriptApi::onLine(QJSValue handler) {
+    if(handler.isCallable()) lineHandlers << handler;
+}
+
+void JsScriptApi::onPrompt(QJSValue handler) {
+    if(handler.isCallable()) promptHandlers << handler;
+}
+
+bool JsScriptApi::hasHandlers() {
+    return !lineHandlers.isEmpty() || !promptHandlers.isEmpty();
+}
+
+bool JsScriptApi::isExiting() {
+    return exiting;
+}
+
+QString JsScriptApi::getError() {
+    return errorMessage;
+}
+
+/* returns as soon as the client reports zero round time; right after a put
+   the roundtime is still the old one, so the new one gets a grace period */
+bool JsScriptApi::waitForRt() {
+    if(rtPending && !this->waitUntil([this]() { return !rtPending; }, JS_RT_GRACE)) return false;
+    rtPending = false;
+    return this->waitUntil([this]() { return data->getRt() == 0; }, 0);
+}
+
+bool JsScriptApi::wait(int ms) {
+    return this->waitUntil(nullptr, ms);
+}
+
+bool JsScriptApi::waitUntil(std::function<bool()> done, int ms) {
+    if(done && done()) return true;
+
+    QEventLoop loop;
+    QEventLoop* outerLoop = waitLoop;
+    std::function<bool()> outerCondition = waitCondition;
+    waitLoop = &loop;
+    waitCondition = done;
+
+    if(ms > 0) QTimer::singleShot(ms, &loop, SLOT(quit()));
+    if(!exiting) loop.exec();
+
+    waitLoop = outerLoop;
+    waitCondition = outerCondition;
+
+    // unwind the script instead of letting it carry on after an abort
+    if(exiting) {
+        qjsEngine(this)->throwError("Script aborted");
+        return false;
+    }
+    return true;
+}
+
+void JsScriptApi::stateChanged(QString field, QVariant value) {
+    Q_UNUSED(value);
+    if(field == "RT") rtPending = false;
+    if(field == "RT" && waitLoop != NULL && waitCondition && waitCondition()) {
+        waitLoop->quit();
+    }
+}
+
+void JsScriptApi::writeText(QString text, bool prompt) {
+    if(exiting) return;
+
+    QList<QJSValue>& handlers = prompt ? promptHandlers : lineHandlers;
+    if(handlers.isEmpty()) return;
+
+    foreach (QString line, text.split("\n")) {
+        line = line.remove(rxRemoveTags);
+        TextUtils::htmlToPlain(line);
+        if(!prompt && line.isEmpty()) continue;
+
+        this->call(handlers, line);
+        if(exiting) return;
+    }
+}
+
+void JsScriptApi::call(QList<QJSValue>& handlers, const QString& text) {
+    // handlers may register more handlers while being called
+    QList<QJSValue> current = handlers;
+    foreach (QJSValue handler, current) {
+        QJSValue result = handler.call(QJSValueList() << text);
+        if(result.isError()) {
+            if(!exiting) {
+                errorMessage = result.toString() + " at line " +
+                        result.property("lineNumber").toString();
+            }
+            this->stop();
+            return;
+        }
+        if(exiting) return;
+    }
+}
+
+void JsScriptApi::exit() {
+    this->stop();
+    qjsEngine(this)->throwError("Script exited");
+}
+
+void JsScriptApi::stop() {
+    exiting = true;
+    if(waitLoop != NULL) waitLoop->quit();
+    emit finished();
+}
+
+void JsScriptApi::abort() {
+    this->stop();
+}
@@ -0,0 +1,76 @@
+#ifndef JSSCRIPTAPI_H
+#define JSSCRIPTAPI_H
+
+#include <QObject>
+#include <QJSValue>
+#include <QVariant>
+#include <QRegExp>
+
+#include <functional>
+
+class JsScript;
+class GameDataContainer;
+class MapData;
+class QEventLoop;
+
+/* Bindings published to scripts as the global "client" object. Lives on
+   the script thread; blocking calls spin a local event loop so line and
+   prompt handlers keep running while a script waits. */
+class JsScriptApi : public QObject {
+    Q_OBJECT
+
+public:
+    JsScriptApi(JsScript* script, MapData* mapData);
+
+    Q_INVOKABLE void put(QString command);
+    Q_INVOKABLE void setPriority(int priority);
+    Q_INVOKABLE void echo(QString text);
+    Q_INVOKABLE QVariant get(QString field);
+
+    Q_INVOKABLE QString findPath(QString zone, int from, int to);
+    Q_INVOKABLE QString findRoute(QString target, int room = -1);
+    Q_INVOKABLE QVariantMap currentRoom();
+
+    Q_INVOKABLE void addWindow(QString id, QString title);
+    Q_INVOKABLE void removeWindow(QString id);
+    Q_INVOKABLE void clearWindow(QString id);
+    Q_INVOKABLE void writeWindow(QString id, QString text);
+
+    Q_INVOKABLE void onLine(QJSValue handler);
+    Q_INVOKABLE void onPrompt(QJSValue handler);
+    Q_INVOKABLE bool waitForRt();
+    Q_INVOKABLE bool wait(int ms);
+    Q_INVOKABLE void exit();
+
+    bool hasHandlers();
+    bool isExiting();
+    QString getError();
+
+private:
+    JsScript* script;
+    MapData* mapData;
+    GameDataContainer* data;
+
+    QList<QJSValue> lineHandlers;
+    QList<QJSValue> promptHandlers;
+    QEventLoop* waitLoop;
+    std::function<bool()> waitCondition;
+    QRegExp rxRemoveTags;
+    QString errorMessage;
+    bool exiting;
+    bool rtPending;
+
+    void call(QList<QJSValue>& handlers, const QString& text);
+    void stop();
+    bool waitUntil(std::function<bool()> done, int ms);
+
+signals:
+    void finished();
+
+public slots:
+    void writeText(QString text, bool prompt);
+    void stateChanged(QString field, QVariant value);
+    void abort();
+};
+
+#endif // JSSCRIPTAPI_H
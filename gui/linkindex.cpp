@@ -0,0 +1,75 @@
+#include "linkindex.h"
+
+#include <QTextLayout>
+
+#include <algorithm>
+
+LinkIndex::LinkIndex() {
+    valid = false;
+}
+
+void LinkIndex::clear() {
+    links.clear();
+}
+
+void LinkIndex::addBlock(const QTextBlock& block, const QPointF& offset) {
+    QTextLayout* layout = block.layout();
+    if(layout == NULL) return;
+
+    QPointF position = offset + layout->position();
+
+    for(QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+        QTextFragment fragment = it.fragment();
+        if(!fragment.isValid() || !fragment.charFormat().isAnchor()) continue;
+
+        QString href = fragment.charFormat().anchorHref();
+        if(href.isEmpty()) continue;
+
+        int start = fragment.position() - block.position();
+        int end = start + fragment.length();
+
+        // a link wrapped over several lines yields one rect per line
+        for(int i = 0; i < layout->lineCount(); i++) {
+            QTextLine line = layout->lineAt(i);
+            int lineStart = qMax(start, line.textStart());
+            int lineEnd = qMin(end, line.textStart() + line.textLength());
+            if(lineStart >= lineEnd) continue;
+
+            qreal x1 = line.cursorToX(lineStart);
+            qreal x2 = line.cursorToX(lineEnd);
+
+            LinkRect link;
+            link.rect = QRectF(qMin(x1, x2), line.y(), qAbs(x2 - x1), line.height()).translated(position);
+            link.href = href;
+            links.append(link);
+        }
+    }
+}
+
+void LinkIndex::finish() {
+    std::sort(links.begin(), links.end(), [](const LinkRect& a, const LinkRect& b) {
+        return a.rect.bottom() < b.rect.bottom();
+    });
+    valid = true;
+}
+
+void LinkIndex::invalidate() {
+    valid = false;
+}
+
+bool LinkIndex::isValid() const {
+    return valid;
+}
+
+QString LinkIndex::anchorAt(const QPointF& pos) const {
+    // lines do not overlap, so the first rect ending below pos starts the candidate line
+    QVector<LinkRect>::const_iterator it = std::upper_bound(links.constBegin(), links.constEnd(), pos.y(),
+        [](qreal y, const LinkRect& link) {
+            return y < link.rect.bottom();
+        });
+
+    for(; it != links.constEnd() && it->rect.top() <= pos.y(); ++it) {
+        if(it->rect.contains(pos)) return it->href;
+    }
+    return QString();
+}
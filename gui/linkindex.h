@@ -0,0 +1,33 @@
+#ifndef LINKINDEX_H
+#define LINKINDEX_H
+
+#include <QRectF>
+#include <QString>
+#include <QVector>
+#include <QTextBlock>
+
+struct LinkRect {
+    QRectF rect;
+    QString href;
+};
+
+class LinkIndex {
+
+public:
+    LinkIndex();
+
+    void clear();
+    void addBlock(const QTextBlock& block, const QPointF& offset);
+    void finish();
+
+    void invalidate();
+    bool isValid() const;
+
+    QString anchorAt(const QPointF& pos) const;
+
+private:
+    QVector<LinkRect> links;
+    bool valid;
+};
+
+#endif // LINKINDEX_H
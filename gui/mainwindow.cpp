@@ -29,13 +29,15 @@
 #include "hyperlinkservice.h"
 #include "session.h"
 #include "scriptstreamserver.h"
+#include "trigger/triggerengine.h"
+#include "trigger/triggersettings.h"
+#include "shareddataservice.h"
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWindow) {
     ui->setupUi(this);
 
     // register types
     qRegisterMetaType<DirectionsList>("DirectionsList");    
-    qRegisterMetaType<GridItems>("GridItems");
 
     // application settings
     this->appSetup();
@@ -135,6 +137,7 @@ void MainWindow::updateProfileSettings(QString name, QString type) {
     SubstitutionSettings::getInstance()->reInit();
     IgnoreSettings::getInstance()->reInit();
     HighlightSettings::getInstance()->reInit();
+    TriggerSettings::getInstance()->reInit();
 
     emit profileChanged();
 }
@@ -203,6 +206,9 @@ void MainWindow::loadClient() {
     addWidgetMainLayout(cmdLine);
 
     scriptService = new ScriptService(this);
+    // session binds parser events to the stream server and triggers
+    scriptStreamServer = new ScriptStreamServer(this);
+    triggerEngine = new TriggerEngine(this);
 
     session = new Session(this, DEBUG);
 
@@ -210,7 +216,6 @@ void MainWindow::loadClient() {
     menuHandler->loadProfilesMenu();
 
     scriptApiServer = new ScriptApiServer(this);
-    scriptStreamServer = new ScriptStreamServer(this);
 
     dictionaryService = new DictionaryService(this);
 
@@ -262,6 +267,10 @@ ScriptStreamServer* MainWindow::getScriptStreamServer() {
     return scriptStreamServer;
 }
 
+TriggerEngine* MainWindow::getTriggerEngine() {
+    return triggerEngine;
+}
+
 DictionaryService* MainWindow::getDictionaryService() {
     return dictionaryService;
 }
@@ -477,10 +486,12 @@ void MainWindow::actionCommands(const QStringList& commands) {
 }
 
 MainWindow::~MainWindow() {
+    scriptApiServer->stop();
     delete ui;
     delete toolBar;
     delete windowFacade;
     delete cmdLine;
     delete menuHandler;
     delete timerBar;
+    SharedDataService::Instance()->close();
 }
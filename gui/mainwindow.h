@@ -38,6 +38,7 @@ class ClientSettings;
 class HyperlinkService;
 class Session;
 class ScriptStreamServer;
+class TriggerEngine;
 class GameWindow;
 
 class MainWindow : public QMainWindow {
@@ -112,6 +113,7 @@ public:
     CommandLine* getCommandLine();
     ScriptService* getScriptService();
     ScriptStreamServer* getScriptStreamServer();
+    TriggerEngine* getTriggerEngine();
     DictionaryService* getDictionaryService();
     TimerBar* getTimerBar();
     Tray* getTray();
@@ -138,6 +140,7 @@ private:
     ScriptService* scriptService;
     ScriptApiServer* scriptApiServer;
     ScriptStreamServer* scriptStreamServer;
+    TriggerEngine* triggerEngine;
     DictionaryService* dictionaryService;
     HyperlinkService* hyperlinkService;
     QMenu* commandMenu;
@@ -0,0 +1,192 @@
+#include "mapcache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+#include "maps/mapzone.h"
+#include "maps/mapnode.h"
+#include "maps/maplabel.h"
+#include "maps/mapdestination.h"
+
+// bump when the layout or the room hash changes
+#define MAP_CACHE_MAGIC 0x46424d43
+#define MAP_CACHE_VERSION 2
+
+/* the map directory is often read only, next to the executable or in a signed bundle */
+MapCache::MapCache(const QDir& mapDir) {
+    this->mapDir = mapDir;
+    this->cacheDir = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/maps");
+}
+
+MapCache::MapCache(const QDir& mapDir, const QDir& cacheDir) {
+    this->mapDir = mapDir;
+    this->cacheDir = cacheDir;
+}
+
+QString MapCache::cachePath(const QString& file) {
+    return cacheDir.filePath(QFileInfo(file).completeBaseName() + ".bin");
+}
+
+bool MapCache::load(const QString& file, CachedZone& cached) {
+    QFileInfo xml(mapDir.filePath(file));
+    QFile cache(this->cachePath(file));
+    if(!cache.open(QIODevice::ReadOnly)) return false;
+
+    // read straight from the mapped file instead of copying it into memory
+    uchar* data = cache.map(0, cache.size());
+    if(data == NULL) return false;
+    QByteArray bytes = QByteArray::fromRawData((const char*)data, cache.size());
+
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version;
+    qint64 size, modified;
+    in >> magic >> version >> size >> modified;
+    if(magic != MAP_CACHE_MAGIC || version != MAP_CACHE_VERSION ||
+            size != xml.size() || modified != xml.lastModified().toMSecsSinceEpoch()) {
+        return false;
+    }
+
+    QString name;
+    int xMin, xMax, yMin, yMax;
+    QList<int> levels;
+    in >> cached.xmlId >> name >> xMin >> xMax >> yMin >> yMax >> levels;
+
+    MapZone* zone = new MapZone(cached.xmlId, name);
+    zone->setFile(file);
+    zone->setXMin(xMin);
+    zone->setXMax(xMax);
+    zone->setYMin(yMin);
+    zone->setYMax(yMax);
+    zone->setLevels(levels);
+
+    qint32 nodeCount;
+    in >> nodeCount;
+    for(int i = 0; i < nodeCount && in.status() == QDataStream::Ok; i++) {
+        qint32 id, x, y, z, arcCount;
+        QString nodeName, color;
+        QStringList desc, notes;
+        in >> id >> nodeName >> desc >> notes >> color >> x >> y >> z >> arcCount;
+
+        MapNode* node = new MapNode(id, nodeName, notes, color);
+        node->setDesc(desc);
+        node->setMapPosition(MapPosition(x, y, z));
+
+        QList<QPair<int, MapDestination*> > arcs;
+        for(int j = 0; j < arcCount; j++) {
+            qint32 key, destId;
+            QString exit, move;
+            bool hidden;
+            in >> key >> destId >> exit >> move >> hidden;
+
+            MapDestination* dest = new MapDestination(destId, exit, move);
+            dest->setHidden(hidden);
+            arcs << qMakePair((int)key, dest);
+        }
+        // stored newest first, inserted oldest first to keep the multi hash order
+        for(int j = arcs.size() - 1; j >= 0; j--) {
+            node->getDestinations().insert(arcs.at(j).first, arcs.at(j).second);
+        }
+        zone->getNodes().insert(id, node);
+    }
+
+    in >> cached.nodeOrder;
+
+    qint32 labelCount;
+    in >> labelCount;
+    for(int i = 0; i < labelCount && in.status() == QDataStream::Ok; i++) {
+        QString text;
+        qint32 x, y, z;
+        in >> text >> x >> y >> z;
+
+        MapLabel* label = new MapLabel(text);
+        label->setPosition(MapPosition(x, y, z));
+        zone->getLabels().append(label);
+    }
+
+    qint32 hashCount;
+    in >> hashCount;
+    for(int i = 0; i < hashCount && in.status() == QDataStream::Ok; i++) {
+        QString hash;
+        qint32 level, nodeId;
+        in >> hash >> level >> nodeId;
+        cached.hashes << qMakePair(hash, RoomNode("", level, nodeId));
+    }
+
+    if(in.status() != QDataStream::Ok) {
+        foreach(MapNode* node, zone->getNodes()) {
+            qDeleteAll(node->getDestinations());
+            delete node;
+        }
+        qDeleteAll(zone->getLabels());
+        delete zone;
+        cached.nodeOrder.clear();
+        cached.hashes.clear();
+        return false;
+    }
+    cached.zone = zone;
+    return true;
+}
+
+void MapCache::save(const QString& file, const CachedZone& cached) {
+    if(!cacheDir.exists() && !cacheDir.mkpath(".")) return;
+
+    QFileInfo xml(mapDir.filePath(file));
+    QSaveFile cache(this->cachePath(file));
+    if(!cache.open(QIODevice::WriteOnly)) return;
+
+    QDataStream out(&cache);
+    out.setVersion(QDataStream::Qt_5_6);
+
+    MapZone* zone = cached.zone;
+    out << (quint32)MAP_CACHE_MAGIC << (quint32)MAP_CACHE_VERSION
+        << (qint64)xml.size() << (qint64)xml.lastModified().toMSecsSinceEpoch();
+    out << cached.xmlId << zone->getName() << zone->getXMin() << zone->getXMax()
+        << zone->getYMin() << zone->getYMax() << zone->getLevels();
+
+    // in id order so an unchanged zone always gives the same file
+    QList<int> ids = zone->getNodes().keys();
+    std::sort(ids.begin(), ids.end());
+
+    out << (qint32)ids.size();
+    foreach(int id, ids) {
+        MapNode* node = zone->getNodes().value(id);
+        MapPosition position = node->getPosition();
+        QMultiHash<int, MapDestination*>& destinations = node->getDestinations();
+
+        out << (qint32)id << node->getName() << node->getDesc() << node->getNotes() << node->getColor()
+            << (qint32)position.getX() << (qint32)position.getY() << (qint32)position.getZ()
+            << (qint32)destinations.size();
+        for(QMultiHash<int, MapDestination*>::const_iterator i = destinations.constBegin(); i != destinations.constEnd(); ++i) {
+            MapDestination* dest = i.value();
+            out << (qint32)i.key() << (qint32)dest->getDestId() << dest->getExit() << dest->getMove() << dest->getHidden();
+        }
+    }
+
+    out << cached.nodeOrder;
+
+    out << (qint32)zone->getLabels().size();
+    foreach(MapLabel* label, zone->getLabels()) {
+        out << label->getText() << (qint32)label->getPosition().getX()
+            << (qint32)label->getPosition().getY() << (qint32)label->getPosition().getZ();
+    }
+
+    out << (qint32)cached.hashes.size();
+    for(int i = 0; i < cached.hashes.size(); i++) {
+        const RoomNode& room = cached.hashes.at(i).second;
+        out << cached.hashes.at(i).first << (qint32)room.getLevel() << (qint32)room.getNodeId();
+    }
+
+    if(out.status() == QDataStream::Ok) {
+        cache.commit();
+    } else {
+        cache.cancelWriting();
+    }
+}
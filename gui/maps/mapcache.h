@@ -0,0 +1,41 @@
+#ifndef MAPCACHE_H
+#define MAPCACHE_H
+
+#include <QDir>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+#include "maps/roomnode.h"
+
+class MapZone;
+
+/* A zone as read from its xml file, before its id is made unique. Room
+   hashes carry no zone id for the same reason. Node ids are kept in file
+   order, later notes win when rooms share one. */
+struct CachedZone {
+    MapZone* zone = nullptr;
+    QString xmlId;
+    QList<int> nodeOrder;
+    QList<QPair<QString, RoomNode> > hashes;
+};
+
+/* Binary copies of parsed zone files, one per zone, used while the xml
+   file keeps the size and modification time it had when it was cached. */
+class MapCache {
+
+public:
+    explicit MapCache(const QDir& mapDir);
+    MapCache(const QDir& mapDir, const QDir& cacheDir);
+
+    bool load(const QString& file, CachedZone& cached);
+    void save(const QString& file, const CachedZone& cached);
+
+private:
+    QDir mapDir;
+    QDir cacheDir;
+
+    QString cachePath(const QString& file);
+};
+
+#endif // MAPCACHE_H
@@ -1,8 +1,8 @@
 #include "mapdata.h"
 #include "maps/mapreader.h"
-#include "maps/mapnode.h"
-#include "maps/mapzone.h"
-#include "maps/mapdestination.h"
+#include "maps/maprouter.h"
+#include "shareddataservice.h"
+#include "gamedatacontainer.h"
 
 MapData::MapData(MapReader* parent) : QObject(parent) {
     mapReader = parent;
@@ -15,9 +15,14 @@ QString MapData::getZones() {
 void MapData::setRoom(const RoomNode& roomNode) {
     QWriteLocker locker(&lock);
     this->roomNode = roomNode;
+
+    locker.unlock();
+
+    SharedDataService::Instance()->setString(SHARED_ROOM_ZONE, roomNode.getZoneId());
+    GameDataContainer::Instance()->setRoomId(roomNode.getNodeId());
 }
 
-const RoomNode& MapData::getRoom() const {
+RoomNode MapData::getRoom() const {
     QReadLocker locker(&lock);
     return this->roomNode;
 }
@@ -33,86 +38,14 @@ RoomNode MapData::findLocation(QString note) {
     }
 }
 
+/* through the router, which is cleared before a reload frees the zones */
 QString MapData::findPath(QString zoneId, int startId, int destId) {
-    MapZone* zone = mapReader->getZones().value(zoneId);
-
-    if(zone == NULL) return "";
-
-    QHash<int, MapNode*>& nodes = zone->getNodes();
-
-    if(!nodes.contains(startId) && !nodes.contains(destId)) return "";
-
-    QList<MapNode*> path = this->getShortestPathBFS(nodes, startId, destId);
-
-    return this->getMoves(path).join(",");
-}
-
-QList<MapNode*> MapData::getShortestPathBFS(QHash<int, MapNode*>& nodes, int startId, int finishId) {
-    QList<int> ids = nodes.keys();
-
-    QHash<int, bool> visited;
-    foreach(int id, ids) visited.insert(id, false);
-
-    QQueue<MapNode*> queue;
-
-    visited.insert(startId, true);
-
-    queue.push_back(nodes.value(startId));
-
-    QHash<MapNode*, MapNode*> prev;
-
-    MapNode* currentNode = NULL;
-    while(!queue.isEmpty()) {
-        currentNode = queue.front();
-
-        if(currentNode->getId() == finishId) break;
-
-        queue.pop_front();        
-
-        QMultiHash<int, MapDestination* >& destinations = currentNode->getDestinations();
-
-        QList<MapDestination*> values = destinations.values();
-        for (int i = 0; i < values.size(); ++i) {
-            int destId = values.at(i)->getDestId();
-            if(!visited.value(destId) && destId != -1) {
-                visited.insert(destId, true);
-
-                MapNode* destNode = nodes.value(destId);                                                
-                if(destNode != NULL) {
-                    queue.push_back(destNode);
-                    prev.insert(destNode, currentNode);
-                }
-            }
-        }
-    }
-
-    MapNode* finish = nodes.value(finishId);
-
-    if(finish == NULL || currentNode != finish) return QList<MapNode*>();
-
-    QList<MapNode*> path;
-    for(MapNode* node = finish; node != NULL; node = prev.value(node)) {
-        path.push_front(node);
-    }
-
-    return path;
+    return mapReader->getRouter()->findPath(zoneId, startId, destId);
 }
 
-QStringList MapData::getMoves(QList<MapNode*> path) {
-    QStringList moves;
-
-    MapNode* prev = path.first();
-    for(int i = 1; i < path.size(); ++i) {
-        MapNode* current = path.value(i);
-        QString move = prev->getDestinations().value(current->getId())->getMove();
-        if(move.isEmpty()) {
-            moves << prev->getDestinations().value(current->getId())->getExit();
-        } else {
-            moves << move;
-        }
-        prev = current;
-    }
-    return moves;
+/* from the current room, across zones when needed */
+QString MapData::findRoute(QString zoneId, int destId) {
+    return mapReader->getRouter()->findRoute(this->getRoom(), zoneId, destId);
 }
 
 RoomNode MapData::findRoomNode(QString hash) {
@@ -7,7 +7,6 @@
 #include "maps/roomnode.h"
 
 class MapReader;
-class MapNode;
 
 class MapData : public QObject {
     Q_OBJECT
@@ -16,12 +15,13 @@ public:
     explicit MapData(MapReader* parent);
 
     QString findPath(QString zoneId, int startId, int destId);
+    QString findRoute(QString zoneId, int destId);
     QString getZones();
 
     RoomNode findRoomNode(QString hash);
 
     void setRoom(const RoomNode& roomNode);
-    const RoomNode& getRoom() const;
+    RoomNode getRoom() const;
 
     RoomNode findLocation(QString keyword);
 
@@ -31,9 +31,6 @@ private:
     MapReader* mapReader;
     RoomNode roomNode;
 
-    QList<MapNode*> getShortestPathBFS(QHash<int, MapNode*>& nodes, int startId, int destId);
-    QStringList getMoves(QList<MapNode*> path);
-
 signals:
 
 public slots:
@@ -119,7 +119,7 @@ void MapDialog::mapLevelSelected(int index) {
 
 void MapDialog::showMap(QString zoneId, int level) {
     ui->nodeInfo->clear();
-    ui->mapView->setScene(mapFacade->getMapReader()->getScenes().value(zoneId).value(level).scene);
+    ui->mapView->setScene(mapFacade->getMapReader()->getScene(zoneId, level).scene);
 }
 
 void MapDialog::center(const RoomNode& roomNode) {
@@ -140,7 +140,7 @@ void MapFacade::showMap(QWidget* widget, QString zoneId, int level) {
 }
 
 void MapFacade::showMap(QString zoneId, int level) {
-    mapView->setScene(mapReader->getScenes().value(zoneId).value(level).scene);
+    mapView->setScene(mapReader->getScene(zoneId, level).scene);
     mapView->viewport()->update();
 }
 
@@ -201,7 +201,7 @@ void MapFacade::moveSelected(QString zoneId, int nodeId, int level) {
     MapZone* zone = mapReader->getZones().value(zoneId);
     MapNode* node = zone->getNodes().value(nodeId);
 
-    MapGraphics map = mapReader->getScenes().value(zoneId).value(level);
+    MapGraphics map = mapReader->getScene(zoneId, level);
     map.selected->setPos(node->getPosition().getX() + abs(zone->getXMin()) -4,
                          node->getPosition().getY() + abs(zone->getYMin()) + MAP_TOP_MARGIN -4);
     map.selected->show();
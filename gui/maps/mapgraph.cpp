@@ -0,0 +1,147 @@
+#include "mapgraph.h"
+
+#include "globaldefines.h"
+
+#include "maps/mapzone.h"
+#include "maps/mapnode.h"
+#include "maps/mapdestination.h"
+
+MapGraph::MapGraph(MapZone* zone) : paths(MAP_PATH_CACHE_SIZE) {
+    QHash<int, MapNode*>& nodes = zone->getNodes();
+
+    nodeIds.reserve(nodes.size());
+    for(QHash<int, MapNode*>::const_iterator i = nodes.constBegin(); i != nodes.constEnd(); ++i) {
+        indexes.insert(i.key(), nodeIds.size());
+        nodeIds.append(i.key());
+    }
+
+    offsets.reserve(nodeIds.size() + 1);
+    offsets.append(0);
+    foreach(int id, nodeIds) {
+        QMultiHash<int, MapDestination*>& destinations = nodes.value(id)->getDestinations();
+
+        // one arc per destination room, moving the way MapData always has
+        QList<int> added;
+        foreach(MapDestination* dest, destinations) {
+            int destId = dest->getDestId();
+            if(destId == -1 || added.contains(destId) || !indexes.contains(destId)) continue;
+            added << destId;
+
+            MapDestination* arc = destinations.value(destId);
+            QString move = arc->getMove().isEmpty() ? arc->getExit() : arc->getMove();
+
+            targets.append(indexes.value(destId));
+            moves.append(move);
+        }
+        offsets.append(targets.size());
+    }
+
+    prev.fill(-1, nodeIds.size());
+    prevArc.fill(-1, nodeIds.size());
+    visited.fill(0, nodeIds.size());
+    queue.resize(nodeIds.size());
+    depth.resize(nodeIds.size());
+    generation = 0;
+}
+
+bool MapGraph::contains(int nodeId) {
+    return indexes.contains(nodeId);
+}
+
+int MapGraph::nodeCount() {
+    return nodeIds.size();
+}
+
+bool MapGraph::isCached(int startId, int destId) {
+    QMutexLocker locker(&mutex);
+    return paths.contains(((quint64)(quint32)startId << 32) | (quint32)destId);
+}
+
+QString MapGraph::findPath(int startId, int destId) {
+    int start = indexes.value(startId, -1);
+    int dest = indexes.value(destId, -1);
+    if(start == -1 || dest == -1 || start == dest) return "";
+
+    quint64 key = ((quint64)(quint32)startId << 32) | (quint32)destId;
+
+    QMutexLocker locker(&mutex);
+    QString* cached = paths.object(key);
+    if(cached != NULL) return *cached;
+
+    QString path;
+    if(this->search(start, dest)) {
+        // the queue is free again, it holds the arcs walked back from the destination
+        int length = 0;
+        for(int node = dest; node != start; node = prev.at(node)) {
+            queue[length++] = prevArc.at(node);
+        }
+        for(int i = length - 1; i >= 0; i--) {
+            path.append(moves.at(queue.at(i)));
+            if(i > 0) path.append(',');
+        }
+    }
+    paths.insert(key, new QString(path));
+    return path;
+}
+
+void MapGraph::markStart(int start) {
+    if(++generation == 0) {
+        visited.fill(0);
+        generation = 1;
+    }
+    visited[start] = generation;
+    queue[0] = start;
+}
+
+/* breadth first; visited marks are generation stamps so nothing is cleared between queries */
+bool MapGraph::search(int start, int dest) {
+    this->markStart(start);
+
+    int head = 0;
+    int tail = 1;
+    while(head < tail) {
+        int node = queue.at(head++);
+        if(node == dest) return true;
+
+        for(int arc = offsets.at(node); arc < offsets.at(node + 1); arc++) {
+            int next = targets.at(arc);
+            if(visited.at(next) != generation) {
+                visited[next] = generation;
+                prev[next] = node;
+                prevArc[next] = arc;
+                queue[tail++] = next;
+            }
+        }
+    }
+    return false;
+}
+
+void MapGraph::distances(int startId, const QVector<int>& destIds, QVector<int>& result) {
+    result.fill(-1, destIds.size());
+
+    int start = indexes.value(startId, -1);
+    if(start == -1) return;
+
+    QMutexLocker locker(&mutex);
+    this->markStart(start);
+    depth[start] = 0;
+
+    int head = 0;
+    int tail = 1;
+    while(head < tail) {
+        int node = queue.at(head++);
+        for(int arc = offsets.at(node); arc < offsets.at(node + 1); arc++) {
+            int next = targets.at(arc);
+            if(visited.at(next) != generation) {
+                visited[next] = generation;
+                depth[next] = depth.at(node) + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+
+    for(int i = 0; i < destIds.size(); i++) {
+        int dest = indexes.value(destIds.at(i), -1);
+        if(dest != -1 && visited.at(dest) == generation) result[i] = depth.at(dest);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef MAPGRAPH_H
+#define MAPGRAPH_H
+
+#include <QVector>
+#include <QHash>
+#include <QCache>
+#include <QMutex>
+#include <QString>
+
+class MapZone;
+
+/* A zone compiled into compressed sparse row form when it is loaded:
+   rooms get dense indexes and the arcs of room i are
+   targets[offsets[i]] .. targets[offsets[i + 1] - 1]. Searches run on
+   these flat arrays with scratch buffers kept between queries. */
+class MapGraph {
+
+public:
+    explicit MapGraph(MapZone* zone);
+
+    /* comma separated moves from start to dest, empty if there is no path */
+    QString findPath(int startId, int destId);
+
+    /* number of moves from start to each of destIds, -1 where unreachable */
+    void distances(int startId, const QVector<int>& destIds, QVector<int>& result);
+
+    bool contains(int nodeId);
+    int nodeCount();
+    /* whether the path from start to dest is answered from the cache */
+    bool isCached(int startId, int destId);
+
+private:
+    QVector<int> nodeIds;
+    QHash<int, int> indexes;
+
+    QVector<int> offsets;
+    QVector<int> targets;
+    QVector<QString> moves;
+
+    QVector<int> prev;
+    QVector<int> prevArc;
+    QVector<uint> visited;
+    QVector<int> queue;
+    QVector<int> depth;
+    uint generation;
+
+    QCache<quint64, QString> paths;
+    QMutex mutex;
+
+    bool search(int start, int dest);
+    void markStart(int start);
+};
+
+#endif // MAPGRAPH_H
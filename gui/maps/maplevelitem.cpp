@@ -0,0 +1,145 @@
+#include "maplevelitem.h"
+
+#include <QPainter>
+#include <QtMath>
+#include <QCursor>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsSceneHoverEvent>
+
+#define MAP_GRID_CELL 16
+
+MapLevelItem::MapLevelItem(QString zoneId, int level, const QRectF& bounds, QColor lineColor) : QGraphicsItem() {
+    this->zoneId = zoneId;
+    this->level = level;
+    this->bounds = bounds;
+    this->lineColor = lineColor;
+
+    tip = NULL;
+    tipIndex = -1;
+
+    // rooms are drawn over labels and the selection marker
+    this->setZValue(1);
+    this->setAcceptHoverEvents(true);
+    this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+void MapLevelItem::addArc(const QLineF& line) {
+    arcs << line;
+}
+
+void MapLevelItem::addNode(int nodeId, const QRectF& rect, const QColor& color) {
+    int index = nodes.size();
+    nodes.append({rect, color, nodeId});
+
+    QRectF hit = rect.adjusted(-1, -1, 1, 1);
+    for(int x = qFloor(hit.left() / MAP_GRID_CELL); x <= qFloor(hit.right() / MAP_GRID_CELL); x++) {
+        for(int y = qFloor(hit.top() / MAP_GRID_CELL); y <= qFloor(hit.bottom() / MAP_GRID_CELL); y++) {
+            grid[cell(x, y)] << index;
+        }
+    }
+}
+
+void MapLevelItem::addEndNode(int nodeId, const QRectF& rect, QString endZoneId) {
+    endNodes << rect;
+    endZones.insert(nodeId, endZoneId);
+}
+
+quint64 MapLevelItem::cell(int x, int y) {
+    return ((quint64)(quint32)x << 32) | (quint32)y;
+}
+
+int MapLevelItem::nodeAt(const QPointF& pos) const {
+    int index = this->indexAt(pos);
+    return index != -1 ? nodes.at(index).id : -1;
+}
+
+int MapLevelItem::indexAt(const QPointF& pos) const {
+    const QVector<int> candidates = grid.value(cell(qFloor(pos.x() / MAP_GRID_CELL),
+                                                    qFloor(pos.y() / MAP_GRID_CELL)));
+    // the last painted room is the one on top
+    for(int i = candidates.size() - 1; i >= 0; i--) {
+        const Node& node = nodes.at(candidates.at(i));
+        if(node.rect.adjusted(-1, -1, 1, 1).contains(pos)) return candidates.at(i);
+    }
+    return -1;
+}
+
+QString MapLevelItem::getEndZone(int nodeId) const {
+    return endZones.value(nodeId);
+}
+
+QString MapLevelItem::getZoneId() const {
+    return zoneId;
+}
+
+int MapLevelItem::getLevel() const {
+    return level;
+}
+
+QRectF MapLevelItem::boundingRect() const {
+    return bounds;
+}
+
+/* only what intersects the exposed area is drawn */
+void MapLevelItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) {
+    Q_UNUSED(widget);
+    const QRectF& exposed = option->exposedRect;
+
+    painter->setPen(lineColor);
+    for(const QLineF& arc : arcs) {
+        if(exposed.intersects(QRectF(arc.p1(), arc.p2()).normalized().adjusted(-1, -1, 1, 1))) {
+            painter->drawLine(arc);
+        }
+    }
+
+    painter->setPen(QColor(0, 170, 255, 255));
+    painter->setBrush(Qt::NoBrush);
+    for(const QRectF& endNode : endNodes) {
+        if(exposed.intersects(endNode)) painter->drawEllipse(endNode);
+    }
+
+    painter->setPen(lineColor);
+    QColor brush;
+    for(const Node& node : nodes) {
+        if(!exposed.intersects(node.rect.adjusted(-1, -1, 1, 1))) continue;
+        if(node.color != brush) {
+            brush = node.color;
+            painter->setBrush(brush);
+        }
+        painter->drawRect(node.rect);
+    }
+}
+
+void MapLevelItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event) {
+    int index = this->indexAt(event->pos());
+    if(index != tipIndex) {
+        this->showTip(index);
+        if(index != -1) {
+            this->setCursor(QCursor(Qt::PointingHandCursor));
+        } else {
+            this->unsetCursor();
+        }
+    }
+}
+
+/* the base handler would repaint the whole level */
+void MapLevelItem::hoverLeaveEvent(QGraphicsSceneHoverEvent* event) {
+    Q_UNUSED(event);
+    this->showTip(-1);
+    this->unsetCursor();
+}
+
+void MapLevelItem::showTip(int index) {
+    tipIndex = index;
+    if(index == -1) {
+        if(tip != NULL) tip->hide();
+        return;
+    }
+    if(tip == NULL) tip = new QGraphicsTextItem(this);
+
+    const Node& node = nodes.at(index);
+    tip->setHtml("<div style=\"background:black;color:white;font-weight:bold;\">" +
+                 QString::number(node.id) + "</div>");
+    tip->setPos(node.rect.right() + 2, node.rect.top() - 10);
+    tip->show();
+}
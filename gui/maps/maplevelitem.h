@@ -0,0 +1,61 @@
+#ifndef MAPLEVELITEM_H
+#define MAPLEVELITEM_H
+
+#include <QGraphicsItem>
+#include <QGraphicsTextItem>
+#include <QVector>
+#include <QHash>
+#include <QColor>
+
+/* Every room, arc and zone exit of one zone level painted by a single item
+   from flat arrays; rooms are found by position through a coarse grid. */
+class MapLevelItem : public QGraphicsItem {
+
+public:
+    MapLevelItem(QString zoneId, int level, const QRectF& bounds, QColor lineColor);
+
+    void addArc(const QLineF& line);
+    void addNode(int nodeId, const QRectF& rect, const QColor& color);
+    void addEndNode(int nodeId, const QRectF& rect, QString endZoneId);
+
+    /* id of the room drawn at pos, -1 if there is none */
+    int nodeAt(const QPointF& pos) const;
+    QString getEndZone(int nodeId) const;
+
+    QString getZoneId() const;
+    int getLevel() const;
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+protected:
+    void hoverMoveEvent(QGraphicsSceneHoverEvent* event) override;
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent* event) override;
+
+private:
+    struct Node {
+        QRectF rect;
+        QColor color;
+        int id;
+    };
+
+    static quint64 cell(int x, int y);
+    int indexAt(const QPointF& pos) const;
+    void showTip(int index);
+
+    QString zoneId;
+    int level;
+    QRectF bounds;
+    QColor lineColor;
+
+    QVector<Node> nodes;
+    QVector<QLineF> arcs;
+    QVector<QRectF> endNodes;
+    QHash<int, QString> endZones;
+    QHash<quint64, QVector<int> > grid;
+
+    QGraphicsTextItem* tip;
+    int tipIndex;
+};
+
+#endif // MAPLEVELITEM_H
@@ -5,32 +5,41 @@
 #include "maps/mapzone.h"
 #include "maps/mapnode.h"
 #include "maps/maplabel.h"
-#include "maps/maprect.h"
+#include "maps/mapscene.h"
+#include "maps/maplevelitem.h"
 #include "maps/mapfacade.h"
 #include "maps/mapdata.h"
 #include "maps/mapdestination.h"
+#include "maps/mapgraph.h"
+#include "maps/maprouter.h"
 
 #include "generalsettings.h"
 #include "textutils.h"
 #include "defaultvalues.h"
 
+#include <QTimer>
+
+#include <functional>
+
 MapReader::MapReader(QObject* parent) : QObject(parent) {
     mapFacade = (MapFacade*)parent;
     initialized = false;
 
     settings = GeneralSettings::getInstance();
-    background = settings->dockWindowBackground();
+    sceneTotal = 0;
 
     mapData = new MapData(this);
+    router = new MapRouter();
 
     dir = QDir(QApplication::applicationDirPath() + "/maps");
+    mapCache = new MapCache(dir);
 
     connect(this, SIGNAL(readyRead()), this, SLOT(initScenes()));
 
     labelsFont = QFont(DEFAULT_FONT, MAP_FONT_SIZE);
 
     QHash<int, MapGraphics> empty;
-    empty.insert(0, {new QGraphicsScene(0, 0, 0, 0, this), NULL});
+    empty.insert(0, {new QGraphicsScene(0, 0, 0, 0, this), NULL, NULL});
     this->scenes.insert("", empty);
 
     this->concurrentInit();
@@ -55,10 +64,33 @@ void MapReader::init() {
 
     QStringList fileList = dir.entryList(filter, QDir::Files, QDir::Name);
 
-    foreach(QString file, fileList) {        
-        MapZone* zone = readZone(dir.path(), file);
+    // zones are read side by side and merged in file order, so duplicate
+    // zone ids get the same suffixes however the reads were scheduled
+    QString path = dir.path();
+    MapCache* cache = mapCache;
+    std::function<CachedZone(const QString&)> load = [path, cache](const QString& file) {
+        CachedZone cached;
+        // xml is only parsed for zones changed since they were cached
+        if(!cache->load(file, cached)) {
+            cached = MapReader::readZone(path, file);
+            if(cached.zone != NULL) cache->save(file, cached);
+        } else {
+            cached.zone->setGraph(new MapGraph(cached.zone));
+        }
+        return cached;
+    };
+    // init already runs on the pool; blockingMapped lets this thread take
+    // part in the reads instead of waiting on a pool it is occupying
+    QList<CachedZone> loaded = QtConcurrent::blockingMapped<QList<CachedZone> >(fileList, load);
+
+    for(int i = 0; i < fileList.size(); i++) {
+        CachedZone cached = loaded.at(i);
+        if(cached.zone == NULL) continue;
+
+        MapZone* zone = this->addZone(fileList.at(i), cached);
         zones.insert(zone->getId(), zone);
     }
+    router->build(zones, connections, roomNodes);
 
     emit readyRead();
 }
@@ -87,9 +119,9 @@ bool MapReader::isInitialized() {
     return this->initialized;
 }
 
+/* scenes are painted when a zone is first shown */
 void MapReader::initScenes() {
-    // TODO DEBUG
-    this->paintScenes();
+    if (!this->getZones().isEmpty()) this->setInitialized(true);
     emit ready();
 }
 
@@ -98,6 +130,89 @@ QHash<QString, QHash<int, MapGraphics> > MapReader::getScenes() {
     return this->scenes;
 }
 
+/* paints the zone on first use and keeps the most recently shown zones */
+MapGraphics MapReader::getScene(QString zoneId, int level) {
+    QWriteLocker locker(&lock);
+    if(!scenes.contains(zoneId)) {
+        MapZone* zone = zones.value(zoneId);
+        if(zone == NULL) return MapGraphics();
+        this->buildScenes(zone);
+
+        // neighbouring zones are likely next, paint them while idle
+        foreach(MapNode* node, zone->getNodes()) {
+            foreach(QString note, node->getNotes()) {
+                QString endZoneId = connections.value(note);
+                if(note.endsWith(".xml") && !endZoneId.isEmpty() && !prefetchQueue.contains(endZoneId)) {
+                    prefetchQueue << endZoneId;
+                }
+            }
+        }
+        if(!prefetchQueue.isEmpty()) QTimer::singleShot(0, this, SLOT(prefetchScenes()));
+    }
+    if(sceneOrder.removeOne(zoneId)) sceneOrder.append(zoneId);
+    this->evictScenes();
+    return scenes.value(zoneId).value(level);
+}
+
+void MapReader::buildScenes(MapZone* zone) {
+    int cost = this->sceneCost(zone);
+    scenes.insert(zone->getId(), this->paintScene(zone));
+    sceneCosts.insert(zone->getId(), cost);
+    sceneOrder.append(zone->getId());
+    sceneTotal += cost;
+}
+
+/* one neighbour per event loop pass, only while it fits the budget */
+void MapReader::prefetchScenes() {
+    QWriteLocker locker(&lock);
+    while(!prefetchQueue.isEmpty()) {
+        MapZone* zone = zones.value(prefetchQueue.takeFirst());
+        if(zone == NULL || scenes.contains(zone->getId())) continue;
+        if(sceneTotal + this->sceneCost(zone) > MAP_SCENE_ITEM_BUDGET) {
+            prefetchQueue.clear();
+            return;
+        }
+        this->buildScenes(zone);
+        // prefetched zones have not been shown, drop them first
+        sceneOrder.removeLast();
+        sceneOrder.prepend(zone->getId());
+        break;
+    }
+    if(!prefetchQueue.isEmpty()) QTimer::singleShot(0, this, SLOT(prefetchScenes()));
+}
+
+/* drops least recently shown zones over the budget, zones on screen stay */
+void MapReader::evictScenes() {
+    for(int i = 0; sceneTotal > MAP_SCENE_ITEM_BUDGET && i < sceneOrder.size() - 1;) {
+        QString zoneId = sceneOrder.at(i);
+        if(this->isShown(zoneId)) {
+            i++;
+            continue;
+        }
+        for(MapGraphics graphic : scenes.take(zoneId).values()) {
+            graphic.scene->deleteLater();
+        }
+        sceneTotal -= sceneCosts.take(zoneId);
+        sceneOrder.removeAt(i);
+    }
+}
+
+bool MapReader::isShown(const QString& zoneId) {
+    for(MapGraphics graphic : scenes.value(zoneId).values()) {
+        if(!graphic.scene->views().isEmpty()) return true;
+    }
+    return false;
+}
+
+/* roughly the number of rooms, arcs and labels the zone paints */
+int MapReader::sceneCost(MapZone* zone) {
+    int cost = zone->getLabels().size();
+    foreach(MapNode* node, zone->getNodes()) {
+        cost += 1 + node->getDestinations().size();
+    }
+    return cost;
+}
+
 QMap<QString, MapZone*> MapReader::getZones() {
     QReadLocker locker(&lock);
     return this->zones;
@@ -118,12 +233,8 @@ MapData* MapReader::getMapData() {
     return mapData;
 }
 
-void MapReader::paintScenes() {
-    QMap<QString, MapZone*>::iterator i;
-    for (i = zones.begin(); i != zones.end(); ++i) {   
-        this->scenes.insert(i.key(), paintScene(i.value()));
-    }
-    if (!zones.isEmpty()) this->setInitialized(true);
+MapRouter* MapReader::getRouter() {
+    return router;
 }
 
 QHash<int, MapGraphics> MapReader::paintScene(MapZone* zone) {
@@ -134,7 +245,7 @@ QHash<int, MapGraphics> MapReader::paintScene(MapZone* zone) {
 
     QList<int>& levels = zone->getLevels();
     foreach(int level, levels) {
-            QGraphicsScene* scene = new QGraphicsScene(0, 0, w, h, mapFacade);
+            MapScene* scene = new MapScene(0, 0, w, h, mapFacade);
             scene->setObjectName(zone->getId());
             QGraphicsTextItem* text = scene->addText(zone->getName() + " (" + QString::number(level) + "/" +
                            QString::number(levels.size() - 1) + ")", labelsFont);
@@ -144,29 +255,37 @@ QHash<int, MapGraphics> MapReader::paintScene(MapZone* zone) {
             QGraphicsEllipseItem* selected = scene->addEllipse(0, 0, 12, 12,  QColor("red"));
             selected->hide();
 
-            scenes.insert(level, {scene, selected});
+            MapLevelItem* rooms = new MapLevelItem(zone->getId(), level, scene->sceneRect(), getLineColor());
+
+            connect(scene, SIGNAL(nodeSelected(QWidget*, QString, int, int)), mapFacade, SLOT(selectNode(QWidget*, QString, int, int)));
+            connect(scene, SIGNAL(go(QWidget*, QString, int)), mapFacade, SLOT(showMap(QWidget*, QString, int)));
+
+            scenes.insert(level, {scene, selected, rooms});
     }
 
     this->paintArcs(zone, scenes);
     this->paintLabels(zone, scenes);
     this->paintNodes(zone, scenes);
 
+    // added once filled so the scene indexes a single finished item
+    foreach(MapGraphics graphics, scenes) {
+        ((MapScene*)graphics.scene)->setLevelItem(graphics.rooms);
+    }
+
     return scenes;
 }
 
 void MapReader::paintArcs(MapZone* zone, QHash<int, MapGraphics>& scenes) {
     foreach(MapNode* node, zone->getNodes()) {
-        QGraphicsScene* scene = scenes.value(node->getPosition().getZ()).scene;
+        MapLevelItem* rooms = scenes.value(node->getPosition().getZ()).rooms;
         foreach(MapDestination* dest, node->getDestinations()) {
             if(!dest->getHidden()) {
                 MapNode* destNode = zone->getNodes().value(dest->getDestId());
                 if(destNode != NULL) {
-                    QGraphicsLineItem* line = scene->addLine(node->getPosition().getX() + abs(zone->getXMin()) + 2,
-                                   node->getPosition().getY() + abs(zone->getYMin()) + 2 + MAP_TOP_MARGIN,
-                                   destNode->getPosition().getX() + abs(zone->getXMin()) + 2,
-                                   destNode->getPosition().getY() + abs(zone->getYMin()) + 2 + MAP_TOP_MARGIN,
-                                   getLineColor());
-                    line->setData(Qt::UserRole, "line");
+                    rooms->addArc(QLineF(node->getPosition().getX() + abs(zone->getXMin()) + 2,
+                                         node->getPosition().getY() + abs(zone->getYMin()) + 2 + MAP_TOP_MARGIN,
+                                         destNode->getPosition().getX() + abs(zone->getXMin()) + 2,
+                                         destNode->getPosition().getY() + abs(zone->getYMin()) + 2 + MAP_TOP_MARGIN));
                 }
             }
         }
@@ -179,14 +298,14 @@ void MapReader::paintLabels(MapZone* zone, QHash<int, MapGraphics>& scenes) {
         QGraphicsTextItem* textItem = scene->addText(label->getText(), labelsFont);
         textItem->setPos(label->getPosition().getX() + abs(zone->getXMin()),
                          label->getPosition().getY() + abs(zone->getYMin()) + MAP_TOP_MARGIN);
-        textItem->setDefaultTextColor(getTextColor(background));
+        textItem->setDefaultTextColor(getTextColor(settings->dockWindowBackground()));
         textItem->setData(Qt::UserRole, "text");
     }
 }
 
 void MapReader::paintNodes(MapZone* zone, QHash<int, MapGraphics>& scenes) {
     foreach(MapNode* node, zone->getNodes()) {
-        QGraphicsScene* scene = scenes.value(node->getPosition().getZ()).scene;
+        MapLevelItem* rooms = scenes.value(node->getPosition().getZ()).rooms;
 
         QColor color;
         if(node->getColor() != NULL) {
@@ -195,47 +314,64 @@ void MapReader::paintNodes(MapZone* zone, QHash<int, MapGraphics>& scenes) {
            color = Qt::lightGray;
         }
 
-        MapRect* item = new MapRect(node->getPosition().getX() + abs(zone->getXMin()),
-                                    node->getPosition().getY() + abs(zone->getYMin()) + MAP_TOP_MARGIN,
-                                    4, 4,
-                                    getLineColor(), color);
-
-        item->setData(Qt::UserRole, "rect");
-        item->setZoneId(zone->getId());
-        item->setNodeId(node->getId());
-        item->setLevel(node->getPosition().getZ());
-        item->setScene(scene);
-
-        connect(item, SIGNAL(nodeSelected(QWidget*, QString, int, int)), mapFacade, SLOT(selectNode(QWidget*, QString, int, int)));
+        qreal x = node->getPosition().getX() + abs(zone->getXMin());
+        qreal y = node->getPosition().getY() + abs(zone->getYMin()) + MAP_TOP_MARGIN;
 
         foreach(QString note, node->getNotes()) {
             if(note.endsWith(".xml")) {
                 QString endZoneId = connections.value(note);
                 if(endZoneId != NULL) {
-                    item->setEndZone(endZoneId);
-                    this->paintEndNode(zone, node, scene);
-                    connect(item, SIGNAL(go(QWidget*, QString, int)), mapFacade, SLOT(showMap(QWidget*, QString, int)));
+                    rooms->addEndNode(node->getId(), QRectF(x - 4, y - 4, 12, 12), endZoneId);
                 }
                 break;
             }
         }
-        scene->addItem(item);
+        rooms->addNode(node->getId(), QRectF(x, y, 4, 4), color);
     }
 }
 
-void MapReader::paintEndNode(MapZone* zone, MapNode* node, QGraphicsScene* scene) {
-    scene->addEllipse(node->getPosition().getX() + abs(zone->getXMin()) -4,
-                      node->getPosition().getY() + abs(zone->getYMin()) + MAP_TOP_MARGIN -4,
-                      12, 12,  QColor(0, 170, 255, 255));
+/* gives the zone its unique id and adds its rooms to the shared lookups */
+MapZone* MapReader::addZone(QString file, CachedZone& cached) {
+    QString id = cached.xmlId;
+    ids << id;
+    int count = ids.count(id);
+    if(count > 1) id += QChar(count + 96);
+    connections.insert(file, id);
+
+    MapZone* zone = cached.zone;
+    zone->setId(id);
+
+    foreach(int nodeId, cached.nodeOrder) {
+        MapNode* node = zone->getNodes().value(nodeId);
+        if(node == NULL) continue;
+        foreach(QString note, node->getNotes()) {
+            locations.insert(note, RoomNode(id, node->getPosition().getZ(), nodeId));
+        }
+    }
+    for(int i = 0; i < cached.hashes.size(); i++) {
+        const RoomNode& room = cached.hashes.at(i).second;
+        roomNodes.insert(cached.hashes.at(i).first, RoomNode(id, room.getLevel(), room.getNodeId()));
+    }
+
+    return zone;
 }
 
-MapZone* MapReader::readZone(QString path, QString file) {
+/* parses one zone file without touching the reader, so files can be read in parallel */
+CachedZone MapReader::readZone(QString path, QString file) {
+    CachedZone cached;
+    cached.zone = NULL;
+
     QFile xmlFile(path + "/" + file);
-    xmlFile.open(QIODevice::ReadOnly);
+    if(!xmlFile.open(QIODevice::ReadOnly)) return cached;
 
     QXmlStreamReader xml;
     xml.setDevice(&xmlFile);
 
+    MapZone* mapZone = NULL;
+    MapNode* mapNode = NULL;
+    MapLabel* mapLabel = NULL;
+    MapPosition position;
+
     while(!xml.atEnd()) {
         if (xml.tokenType() == QXmlStreamReader::Invalid) {
             xml.readNext();
@@ -244,13 +380,11 @@ MapZone* MapReader::readZone(QString path, QString file) {
         xml.readNext();
 
         if(xml.name() == "zone" && xml.isStartElement()) {
-            QString id = xml.attributes().value("id").toString();
-            ids << id;
-            int count = ids.count(id);
-            if(count > 1) id += QChar(count + 96);
-            connections.insert(file, id);
-            mapZone = new MapZone(id, xml.attributes().value("name").toString());
+            cached.xmlId = xml.attributes().value("id").toString();
+            mapZone = new MapZone(cached.xmlId, xml.attributes().value("name").toString());
             mapZone->setFile(file);            
+        } else if(mapZone == NULL) {
+            continue;
         } else if (xml.name() == "node") {
             if(xml.isStartElement()) {
                 QString note = xml.attributes().value("note").toString();
@@ -260,17 +394,14 @@ MapZone* MapReader::readZone(QString path, QString file) {
 
                 mapNode = new MapNode(xml.attributes().value("id").toInt(), xml.attributes().value("name").toString(),
                                       notes, xml.attributes().value("color").toString());
-            } else {
+            } else if(mapNode != NULL) {
                 mapNode->setMapPosition(position);
                 mapZone->getNodes().insert(mapNode->getId(), mapNode);
+                cached.nodeOrder << mapNode->getId();
 
-                foreach(QString note, mapNode->getNotes()) {
-                    locations.insert(note, RoomNode(mapZone->getId(), mapNode->getPosition().getZ(), mapNode->getId()));
-                }
-
-                this->roomToHash();
+                cached.hashes += MapReader::roomToHash(mapNode);
             }
-        } else if (xml.name() == "description" && xml.isStartElement()) {
+        } else if (xml.name() == "description" && xml.isStartElement() && mapNode != NULL) {
             mapNode->getDesc().append(xml.readElementText());
         } else if (xml.name() == "position" && xml.isStartElement()) {
             QXmlStreamAttributes attr = xml.attributes();
@@ -289,7 +420,7 @@ MapZone* MapReader::readZone(QString path, QString file) {
 
                 position = MapPosition(x, y, z);
             }
-        } else if(xml.name() == "arc" && xml.isStartElement()) {
+        } else if(xml.name() == "arc" && xml.isStartElement() && mapNode != NULL) {
             QXmlStreamAttributes attr = xml.attributes();
 
             MapDestination* dest = new MapDestination();
@@ -310,19 +441,25 @@ MapZone* MapReader::readZone(QString path, QString file) {
         } else if(xml.name() == "label") {
             if(xml.isStartElement()) {
                 mapLabel = new MapLabel(xml.attributes().value("text").toString());
-            } else {
+            } else if(mapLabel != NULL) {
                 mapLabel->setPosition(position);
                 mapZone->getLabels().append(mapLabel);
             }
         }
     }
+    if(mapZone == NULL) return cached;
 
     qSort(mapZone->getLevels());
 
-    return mapZone;
+    // compiled once here so path queries do not touch the node hashes
+    mapZone->setGraph(new MapGraph(mapZone));
+
+    cached.zone = mapZone;
+    return cached;
 }
 
-void MapReader::roomToHash() {
+/* room hashes without a zone id, the zone id is only final once all zones are read */
+QList<QPair<QString, RoomNode> > MapReader::roomToHash(MapNode* mapNode) {
     QMultiHash<int, MapDestination* >& dest = mapNode->getDestinations();
 
     QList<QString> list;
@@ -334,6 +471,7 @@ void MapReader::roomToHash() {
     }
     qSort(list);
 
+    QList<QPair<QString, RoomNode> > hashes;
     QStringList descList = mapNode->getDesc();
     foreach(QString desc, descList) {
         TextUtils::plainToHtml(desc);
@@ -341,19 +479,16 @@ void MapReader::roomToHash() {
         QString text = "[" + mapNode->getName() + "]" + desc + list.join("");
         QString hash = TextUtils::toHash(text);
 
-        /*if(mapNode->getId() == 192) {
-            qDebug() << text;
-            qDebug() << hash;
-        }*/
-
         int level = mapNode->getPosition().getZ();
         int nodeId = mapNode->getId();
 
-        roomNodes.insert(hash, RoomNode(mapZone->getId(), level, nodeId));
+        hashes << qMakePair(hash, RoomNode("", level, nodeId));
     }
+    return hashes;
 }
 
 void MapReader::uninit() {
+    router->clear();
     QWriteLocker locker(&lock);
     for(MapZone* zone : zones.values()) {
         QHash<int, MapGraphics> graphics = this->scenes.value(zone->getId());
@@ -369,6 +504,7 @@ void MapReader::uninit() {
             }
             delete node;
         }
+        delete zone->getGraph();
         delete zone;
     }
     this->clear();
@@ -376,7 +512,14 @@ void MapReader::uninit() {
 
 void MapReader::clear() {
     zones.clear();
+    // keep the empty scene shown while nothing is loaded
+    QHash<int, MapGraphics> empty = scenes.value("");
     scenes.clear();
+    scenes.insert("", empty);
+    sceneOrder.clear();
+    sceneCosts.clear();
+    sceneTotal = 0;
+    prefetchQueue.clear();
     connections.clear();
     locations.clear();
     roomNodes.clear();
@@ -389,4 +532,6 @@ bool MapReader::isInRange(int n) {
 
 MapReader::~MapReader() {
     this->uninit();
+    delete router;
+    delete mapCache;
 }
@@ -17,10 +17,14 @@
 
 #include "maps/mapposition.h"
 #include "maps/roomnode.h"
+#include "maps/mapcache.h"
+
+class MapLevelItem;
 
 struct MapGraphics {
     QGraphicsScene* scene;
     QGraphicsEllipseItem* selected;
+    MapLevelItem* rooms;
 };
 
 class MapFacade;
@@ -29,6 +33,7 @@ class MapZone;
 class MapNode;
 class MapLabel;
 class GeneralSettings;
+class MapRouter;
 
 class MapReader : public QObject {
     Q_OBJECT
@@ -39,9 +44,11 @@ public:
 
     QMap<QString, MapZone*> getZones();
     QHash<QString, QHash<int, MapGraphics> > getScenes();
+    MapGraphics getScene(QString zoneId, int level);
     QMultiHash<QString, RoomNode> getRoomNodes();
 
     MapData* getMapData();
+    MapRouter* getRouter();
     QHash<QString, RoomNode> getLocations();
 
     QDir getDir();
@@ -54,15 +61,15 @@ public:
     QColor getLineColor();
 
 private:
-    MapZone* readZone(QString path, QString file);
+    static CachedZone readZone(QString path, QString file);
+    static QList<QPair<QString, RoomNode> > roomToHash(MapNode* mapNode);
+    MapZone* addZone(QString file, CachedZone& cached);
 
     void paintArcs(MapZone* zone, QHash<int, MapGraphics>& scenes);
     void paintLabels(MapZone* zone, QHash<int, MapGraphics>& scenes);
     void paintNodes(MapZone* zone, QHash<int, MapGraphics>& scenes);
-    void paintEndNode(MapZone* zone, MapNode* node, QGraphicsScene* scene);
 
-    bool isInRange(int n);
-    void roomToHash();
+    static bool isInRange(int n);
 
     void setInitialized(bool initialized);
 
@@ -76,17 +83,22 @@ private:
 
     MapFacade* mapFacade;
     MapData* mapData;
+    MapRouter* router;
 
-    void paintScenes();
     QHash<int, MapGraphics> paintScene(MapZone* zone);
+    void buildScenes(MapZone* zone);
+    void evictScenes();
+    bool isShown(const QString& zoneId);
+    int sceneCost(MapZone* zone);
 
-    MapZone* mapZone;
-    MapNode* mapNode;
-    MapLabel* mapLabel;
-    MapPosition position;
+    MapCache* mapCache;
 
     QMap<QString, MapZone*> zones;
     QHash<QString, QHash<int, MapGraphics> > scenes;
+    QStringList sceneOrder;
+    QHash<QString, int> sceneCosts;
+    int sceneTotal;
+    QStringList prefetchQueue;
     QHash<QString, QString> connections;
     QHash<QString, RoomNode> locations;
 
@@ -97,7 +109,6 @@ private:
     QReadWriteLock lock;
 
     GeneralSettings* settings;
-    QColor background;
 
     QFutureWatcher<void> reloadWatcher;
 
@@ -107,6 +118,7 @@ signals:
 
 public slots:
     void initScenes();
+    void prefetchScenes();
     void reload();
     void concurrentInit();
 };
@@ -0,0 +1,247 @@
+#include "maprouter.h"
+
+#include <queue>
+#include <climits>
+
+#include "maps/mapzone.h"
+#include "maps/mapnode.h"
+#include "maps/mapgraph.h"
+
+MapRouter::MapRouter() {
+}
+
+void MapRouter::build(const QMap<QString, MapZone*>& zones, const QHash<QString, QString>& connections,
+                      const QMultiHash<QString, RoomNode>& roomNodes) {
+    QWriteLocker locker(&lock);
+    this->zones = zones;
+    portals.clear();
+    zonePortals.clear();
+    zonePortalNodes.clear();
+    edges.clear();
+    reachable.clear();
+
+    // hashes of each room, to find the same room in another zone
+    QHash<QPair<QString, int>, QStringList> roomHashes;
+    for(QMultiHash<QString, RoomNode>::const_iterator i = roomNodes.constBegin(); i != roomNodes.constEnd(); ++i) {
+        roomHashes[qMakePair(i.value().getZoneId(), i.value().getNodeId())] << i.key();
+    }
+
+    QHash<QPair<QString, int>, int> index;
+    QList<Edge> links;
+    foreach(MapZone* zone, zones) {
+        foreach(MapNode* node, zone->getNodes()) {
+            foreach(QString note, node->getNotes()) {
+                if(!note.endsWith(".xml")) continue;
+
+                QString targetZoneId = connections.value(note);
+                MapZone* target = zones.value(targetZoneId);
+                if(target == NULL || target == zone) continue;
+
+                int targetId = -1;
+                foreach(QString hash, roomHashes.value(qMakePair(zone->getId(), node->getId()))) {
+                    foreach(RoomNode room, roomNodes.values(hash)) {
+                        if(room.getZoneId() == targetZoneId) {
+                            targetId = room.getNodeId();
+                            break;
+                        }
+                    }
+                    if(targetId != -1) break;
+                }
+                // no matching description, fall back to a room of the same name leading back
+                if(targetId == -1) {
+                    foreach(MapNode* candidate, target->getNodes()) {
+                        if(candidate->getName() == node->getName() && candidate->getNotes().contains(zone->getFile())) {
+                            targetId = candidate->getId();
+                            break;
+                        }
+                    }
+                }
+                if(targetId == -1) continue;
+
+                int from = this->addPortal(zone->getId(), node->getId(), index);
+                int to = this->addPortal(targetZoneId, targetId, index);
+                links << Edge(from, to);
+            }
+        }
+    }
+
+    edges.resize(portals.size());
+    foreach(Edge link, links) {
+        edges[link.first] << Edge(link.second, 0);
+    }
+
+    // moves between every pair of portals within a zone
+    QVector<int> distances;
+    foreach(QString zoneId, zonePortals.keys()) {
+        const QVector<int>& ids = zonePortals[zoneId];
+        const QVector<int>& nodeIds = zonePortalNodes[zoneId];
+        MapGraph* graph = zones.value(zoneId)->getGraph();
+
+        for(int i = 0; i < ids.size(); i++) {
+            graph->distances(nodeIds.at(i), nodeIds, distances);
+            for(int j = 0; j < ids.size(); j++) {
+                if(distances.at(j) > 0) edges[ids.at(i)] << Edge(ids.at(j), distances.at(j));
+            }
+        }
+    }
+
+    this->linkZones();
+}
+
+int MapRouter::addPortal(const QString& zoneId, int nodeId, QHash<QPair<QString, int>, int>& index) {
+    QPair<QString, int> key = qMakePair(zoneId, nodeId);
+    if(index.contains(key)) return index.value(key);
+
+    int id = portals.size();
+    portals.append({zoneId, nodeId});
+    zonePortals[zoneId] << id;
+    zonePortalNodes[zoneId] << nodeId;
+    index.insert(key, id);
+    return id;
+}
+
+/* zones reachable from each zone, so unreachable routes are refused without a search */
+void MapRouter::linkZones() {
+    QHash<QString, QSet<QString> > links;
+    for(int i = 0; i < edges.size(); i++) {
+        foreach(Edge edge, edges.at(i)) {
+            const QString& from = portals.at(i).zoneId;
+            const QString& to = portals.at(edge.first).zoneId;
+            if(from != to) links[from] << to;
+        }
+    }
+
+    foreach(QString zoneId, zones.keys()) {
+        QSet<QString>& seen = reachable[zoneId];
+        QList<QString> queue;
+        queue << zoneId;
+        seen << zoneId;
+        while(!queue.isEmpty()) {
+            foreach(QString next, links.value(queue.takeFirst())) {
+                if(!seen.contains(next)) {
+                    seen << next;
+                    queue << next;
+                }
+            }
+        }
+    }
+}
+
+bool MapRouter::isConnected(const QString& fromZoneId, const QString& toZoneId) {
+    QReadLocker locker(&lock);
+    return reachable.value(fromZoneId).contains(toZoneId);
+}
+
+QString MapRouter::legPath(const QString& zoneId, int from, int to) {
+    if(from == to) return QString();
+    return zones.value(zoneId)->getGraph()->findPath(from, to);
+}
+
+/* within one zone; the lock keeps the graph alive while a reload waits in clear */
+QString MapRouter::findPath(const QString& zoneId, int startId, int destId) {
+    QReadLocker locker(&lock);
+    MapZone* zone = zones.value(zoneId);
+    if(zone == NULL || zone->getGraph() == NULL) return QString();
+    return zone->getGraph()->findPath(startId, destId);
+}
+
+QString MapRouter::findRoute(const RoomNode& start, const QString& destZoneId, int destId) {
+    QReadLocker locker(&lock);
+
+    MapZone* startZone = zones.value(start.getZoneId());
+    MapZone* destZone = zones.value(destZoneId);
+    if(startZone == NULL || destZone == NULL) return QString();
+    if(!startZone->getGraph()->contains(start.getNodeId()) || !destZone->getGraph()->contains(destId)) {
+        return QString();
+    }
+
+    if(startZone == destZone) {
+        QString path = this->legPath(destZoneId, start.getNodeId(), destId);
+        // a room that can only be reached through another zone is routed below
+        if(!path.isEmpty() || start.getNodeId() == destId) return path;
+    }
+    if(!reachable.value(start.getZoneId()).contains(destZoneId)) return QString();
+
+    // shortest path over portals with the destination as an extra node
+    const int dest = portals.size();
+    QVector<int> dist(dest + 1, INT_MAX);
+    QVector<int> prev(dest + 1, -1);
+
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+
+    QVector<int> distances;
+    const QVector<int>& startPortals = zonePortals.value(start.getZoneId());
+    startZone->getGraph()->distances(start.getNodeId(), zonePortalNodes.value(start.getZoneId()), distances);
+    for(int i = 0; i < startPortals.size(); i++) {
+        if(distances.at(i) >= 0) {
+            dist[startPortals.at(i)] = distances.at(i);
+            queue.push(Entry(distances.at(i), startPortals.at(i)));
+        }
+    }
+
+    QHash<int, int> toDest;
+    QVector<int> destIds;
+    destIds << destId;
+    foreach(int portal, zonePortals.value(destZoneId)) {
+        destZone->getGraph()->distances(portals.at(portal).nodeId, destIds, distances);
+        if(distances.at(0) >= 0) toDest.insert(portal, distances.at(0));
+    }
+
+    while(!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+
+        int node = entry.second;
+        if(entry.first > dist.at(node)) continue;
+        if(node == dest) break;
+
+        foreach(Edge edge, edges.at(node)) {
+            int next = edge.first;
+            if(entry.first + edge.second < dist.at(next)) {
+                dist[next] = entry.first + edge.second;
+                prev[next] = node;
+                queue.push(Entry(dist.at(next), next));
+            }
+        }
+        if(toDest.contains(node) && entry.first + toDest.value(node) < dist.at(dest)) {
+            dist[dest] = entry.first + toDest.value(node);
+            prev[dest] = node;
+            queue.push(Entry(dist.at(dest), dest));
+        }
+    }
+    if(dist.at(dest) == INT_MAX) return QString();
+
+    QList<int> chain;
+    for(int node = prev.at(dest); node != -1; node = prev.at(node)) {
+        chain.prepend(node);
+    }
+
+    // walk each zone leg; crossing a portal is the same room and costs no move
+    QStringList moves;
+    QString zoneId = start.getZoneId();
+    int from = start.getNodeId();
+    foreach(int portal, chain) {
+        const Portal& next = portals.at(portal);
+        if(next.zoneId == zoneId) {
+            QString leg = this->legPath(zoneId, from, next.nodeId);
+            if(!leg.isEmpty()) moves << leg;
+        }
+        zoneId = next.zoneId;
+        from = next.nodeId;
+    }
+    QString leg = this->legPath(zoneId, from, destId);
+    if(!leg.isEmpty()) moves << leg;
+
+    return moves.join(",");
+}
+
+void MapRouter::clear() {
+    QWriteLocker locker(&lock);
+    zones.clear();
+    portals.clear();
+    zonePortals.clear();
+    zonePortalNodes.clear();
+    edges.clear();
+    reachable.clear();
+}
@@ -0,0 +1,56 @@
+#ifndef MAPROUTER_H
+#define MAPROUTER_H
+
+#include <QHash>
+#include <QMap>
+#include <QVector>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QReadWriteLock>
+
+#include "maps/roomnode.h"
+
+class MapZone;
+
+/* Routes across zones. Rooms whose notes name another zone's file are
+   portals; each is linked to the same room in that zone, found by room
+   hash or else by name. Moves between the portals of a zone are
+   precomputed, so a route is a shortest path search over portals only. */
+class MapRouter {
+
+public:
+    MapRouter();
+
+    void build(const QMap<QString, MapZone*>& zones, const QHash<QString, QString>& connections,
+               const QMultiHash<QString, RoomNode>& roomNodes);
+    void clear();
+
+    /* comma separated moves, empty if the room can not be reached */
+    QString findRoute(const RoomNode& start, const QString& destZoneId, int destId);
+    QString findPath(const QString& zoneId, int startId, int destId);
+
+    bool isConnected(const QString& fromZoneId, const QString& toZoneId);
+
+private:
+    struct Portal {
+        QString zoneId;
+        int nodeId;
+    };
+    typedef QPair<int, int> Edge;
+
+    QMap<QString, MapZone*> zones;
+    QVector<Portal> portals;
+    QHash<QString, QVector<int> > zonePortals;
+    QHash<QString, QVector<int> > zonePortalNodes;
+    QVector<QVector<Edge> > edges;
+    QHash<QString, QSet<QString> > reachable;
+
+    QReadWriteLock lock;
+
+    int addPortal(const QString& zoneId, int nodeId, QHash<QPair<QString, int>, int>& index);
+    void linkZones();
+    QString legPath(const QString& zoneId, int from, int to);
+};
+
+#endif // MAPROUTER_H
@@ -7,10 +7,14 @@ HEADERS += \
     $$PWD/maplabel.h \
     $$PWD/mapwindow.h \
     $$PWD/mapwindowfactory.h \
-    $$PWD/maprect.h \
+    $$PWD/mapscene.h \
+    $$PWD/maplevelitem.h \
     $$PWD/mapfacade.h \
     $$PWD/mapdialog.h \
     $$PWD/mapdata.h \
+    $$PWD/mapgraph.h \
+    $$PWD/mapcache.h \
+    $$PWD/maprouter.h \
     $$PWD/roomnode.h
 
 SOURCES += \
@@ -22,10 +26,14 @@ SOURCES += \
     $$PWD/maplabel.cpp \
     $$PWD/mapwindow.cpp \
     $$PWD/mapwindowfactory.cpp \
-    $$PWD/maprect.cpp \
+    $$PWD/mapscene.cpp \
+    $$PWD/maplevelitem.cpp \
     $$PWD/mapfacade.cpp \
     $$PWD/mapdialog.cpp \
     $$PWD/mapdata.cpp \
+    $$PWD/mapgraph.cpp \
+    $$PWD/mapcache.cpp \
+    $$PWD/maprouter.cpp \
     $$PWD/roomnode.cpp
 
 FORMS += \
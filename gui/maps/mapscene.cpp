@@ -0,0 +1,28 @@
+#include "mapscene.h"
+
+#include "maps/maplevelitem.h"
+
+MapScene::MapScene(qreal x, qreal y, qreal w, qreal h, QObject* parent) : QGraphicsScene(x, y, w, h, parent) {
+    levelItem = NULL;
+}
+
+void MapScene::setLevelItem(MapLevelItem* levelItem) {
+    this->levelItem = levelItem;
+    this->addItem(levelItem);
+}
+
+MapLevelItem* MapScene::getLevelItem() {
+    return levelItem;
+}
+
+void MapScene::mousePressEvent(QGraphicsSceneMouseEvent* event) {
+    if(levelItem != NULL && (event->buttons() & Qt::LeftButton)) {
+        int nodeId = levelItem->nodeAt(levelItem->mapFromScene(event->scenePos()));
+        if(nodeId != -1) {
+            QString endZoneId = levelItem->getEndZone(nodeId);
+            if(!endZoneId.isEmpty()) emit go(event->widget(), endZoneId, levelItem->getLevel());
+            emit nodeSelected(event->widget(), levelItem->getZoneId(), levelItem->getLevel(), nodeId);
+        }
+    }
+    QGraphicsScene::mousePressEvent(event);
+}
@@ -0,0 +1,31 @@
+#ifndef MAPSCENE_H
+#define MAPSCENE_H
+
+#include <QGraphicsScene>
+#include <QGraphicsSceneMouseEvent>
+
+class MapLevelItem;
+
+/* Scene of one zone level; room clicks are resolved here
+   instead of by an object per room. */
+class MapScene : public QGraphicsScene {
+    Q_OBJECT
+
+public:
+    MapScene(qreal x, qreal y, qreal w, qreal h, QObject* parent = 0);
+
+    void setLevelItem(MapLevelItem* levelItem);
+    MapLevelItem* getLevelItem();
+
+signals:
+    void go(QWidget*, QString endNode, int level);
+    void nodeSelected(QWidget*, QString zoneid, int level, int nodeId);
+
+protected:
+    void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
+
+private:
+    MapLevelItem* levelItem;
+};
+
+#endif // MAPSCENE_H
@@ -7,6 +7,8 @@ MapZone::MapZone() {
     this->xMin = 10000;
     this->yMax = -10000;
     this->yMin = 10000;
+
+    this->graph = NULL;
 }
 
 MapZone::MapZone(QString id, QString name) {
@@ -17,6 +19,8 @@ MapZone::MapZone(QString id, QString name) {
     this->xMin = 10000;
     this->yMax = -10000;
     this->yMin = 10000;
+
+    this->graph = NULL;
 }
 
 QString MapZone::getId() {
@@ -98,3 +102,11 @@ QList<int>& MapZone::getLevels() {
 void MapZone::setLevels(QList<int> levels){
     this->levels = levels;
 }
+
+MapGraph* MapZone::getGraph() {
+    return graph;
+}
+
+void MapZone::setGraph(MapGraph* graph) {
+    this->graph = graph;
+}
@@ -7,6 +7,7 @@
 
 class MapNode;
 class MapLabel;
+class MapGraph;
 
 class MapZone {
 
@@ -42,6 +43,9 @@ public:
     QList<int>& getLevels();
     void setLevels(QList<int> levels);
 
+    MapGraph* getGraph();
+    void setGraph(MapGraph* graph);
+
 private:
     QString id;
     QString name;
@@ -57,6 +61,7 @@ private:
 
     QList<int> levels;
 
+    MapGraph* graph;
 };
 
 #endif // MAPZONE_H
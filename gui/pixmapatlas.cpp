@@ -0,0 +1,96 @@
+#include "pixmapatlas.h"
+
+#include <QGuiApplication>
+
+PixmapAtlas* PixmapAtlas::m_pInstance = NULL;
+
+PixmapAtlas* PixmapAtlas::Instance() {
+    if (!m_pInstance) {
+        m_pInstance = new PixmapAtlas;
+    }
+    return m_pInstance;
+}
+
+PixmapAtlas::PixmapAtlas(QObject *parent) : QObject(parent) {
+    pixelRatio = qApp->devicePixelRatio();
+}
+
+void PixmapAtlas::checkPixelRatio() {
+    qreal ratio = qApp->devicePixelRatio();
+    if(ratio != pixelRatio) {
+        this->clear();
+        pixelRatio = ratio;
+    }
+}
+
+QString PixmapAtlas::sizeKey(const QSize& size) {
+    if(!size.isValid()) return "";
+    return "@" + QString::number(size.width()) + "x" + QString::number(size.height());
+}
+
+QPixmap PixmapAtlas::pixmap(const QString& resource, const QSize& size) {
+    this->checkPixelRatio();
+
+    QString key = resource + sizeKey(size);
+    QHash<QString, QPixmap>::const_iterator it = resources.constFind(key);
+    if(it != resources.constEnd()) {
+        return it.value();
+    }
+
+    QPixmap image(resource);
+    if(!image.isNull() && size.isValid()) {
+        image = image.scaled(size * pixelRatio, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        image.setDevicePixelRatio(pixelRatio);
+    }
+    resources.insert(key, image);
+
+    return image;
+}
+
+QPixmap PixmapAtlas::render(const QString& key, const QSize& size, std::function<void(QPainter&)> paint) {
+    this->checkPixelRatio();
+
+    QString renderKey = key + sizeKey(size);
+    QHash<QString, QPixmap>::const_iterator it = rendered.constFind(renderKey);
+    if(it != rendered.constEnd()) {
+        return it.value();
+    }
+
+    if(rendered.size() >= MAX_RENDERED) {
+        rendered.clear();
+    }
+
+    QPixmap image(size * pixelRatio);
+    image.setDevicePixelRatio(pixelRatio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    if(painter.isActive()) {
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        paint(painter);
+        painter.end();
+    }
+    rendered.insert(renderKey, image);
+
+    return image;
+}
+
+void PixmapAtlas::preload(const QStringList& resourceList, const QSize& size) {
+    foreach(const QString& resource, resourceList) {
+        this->pixmap(resource, size);
+    }
+}
+
+void PixmapAtlas::invalidate(const QString& prefix) {
+    foreach(const QString& key, resources.keys()) {
+        if(key.startsWith(prefix)) resources.remove(key);
+    }
+    foreach(const QString& key, rendered.keys()) {
+        if(key.startsWith(prefix)) rendered.remove(key);
+    }
+}
+
+void PixmapAtlas::clear() {
+    resources.clear();
+    rendered.clear();
+}
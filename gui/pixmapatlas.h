@@ -0,0 +1,49 @@
+#ifndef PIXMAPATLAS_H
+#define PIXMAPATLAS_H
+
+#include <QObject>
+#include <QHash>
+#include <QPixmap>
+#include <QPainter>
+
+#include <functional>
+
+/*
+ * Cache of pre-rendered pixmaps for the toolbar, compass and
+ * roundtime display. Entries are rendered once at the current
+ * device pixel ratio and dropped when the ratio or scale changes.
+ * Only used from the GUI thread.
+ */
+class PixmapAtlas : public QObject {
+    Q_OBJECT
+
+public:
+    static PixmapAtlas* Instance();
+
+    QPixmap pixmap(const QString& resource, const QSize& size = QSize());
+    QPixmap render(const QString& key, const QSize& size, std::function<void(QPainter&)> paint);
+    void preload(const QStringList& resources, const QSize& size);
+
+    void invalidate(const QString& prefix);
+    void clear();
+
+private:
+    PixmapAtlas(QObject *parent = 0);
+    PixmapAtlas(PixmapAtlas const& copy);
+    PixmapAtlas& operator = (PixmapAtlas const& copy);
+    static PixmapAtlas* m_pInstance;
+
+    // generated entries (compass states, roundtime strips) are
+    // bounded; resource entries are limited by the image set
+    static const int MAX_RENDERED = 512;
+
+    QHash<QString, QPixmap> resources;
+    QHash<QString, QPixmap> rendered;
+
+    qreal pixelRatio;
+
+    void checkPixelRatio();
+    QString sizeKey(const QSize& size);
+};
+
+#endif // PIXMAPATLAS_H
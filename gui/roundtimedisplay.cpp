@@ -5,11 +5,15 @@
 #include "globaldefines.h"
 #include "generalsettings.h"
 #include "commandline.h"
+#include "uiupdatequeue.h"
+#include "pixmapatlas.h"
 
 RoundTimeDisplay::RoundTimeDisplay(QObject *parent) : QObject(parent) {
     mainWindow = (MainWindow*)parent;
     data = GameDataContainer::Instance();
     settings = GeneralSettings::getInstance();
+    uiUpdateQueue = UiUpdateQueue::Instance();
+    pixmapAtlas = PixmapAtlas::Instance();
 
     timer = new QTimer;
     timer->setInterval(RT_INTERVAL_MS);
@@ -32,6 +36,7 @@ void RoundTimeDisplay::loadSettings() {
 void RoundTimeDisplay::reloadSettings() {
     settings = GeneralSettings::getInstance();
     this->loadSettings();
+    uiUpdateQueue->invalidate("roundtime");
 }
 
 void RoundTimeDisplay::initTimer() {
@@ -75,32 +80,37 @@ void RoundTimeDisplay::intervalEvent() {
 }
 
 void RoundTimeDisplay::repaint() {
+    uiUpdateQueue->invalidate("roundtime");
     emit callPaint(roundTime, castTime);
 }
 
 void RoundTimeDisplay::paint(int rt, int ct) {
+    // timer ticks several times per second; only
+    // repaint when the displayed seconds change
+    bool clear = rt < RT_INTERVAL_MS && ct < RT_INTERVAL_MS;
+    int rt_s = clear ? -1 : toSeconds(rt);
+    int ct_s = clear ? -1 : toSeconds(ct);
+    if(!uiUpdateQueue->changed("roundtime", QPoint(rt_s, ct_s))) return;
+
     CommandLine* cmd = mainWindow->getCommandLine();
-    if(rt < RT_INTERVAL_MS && ct < RT_INTERVAL_MS) {
-        cmd->clearRt();
-    } else {
-        int rt_s = toSeconds(rt);
-        int ct_s = toSeconds(ct);
-        cmd->insertRt(segmentDisplay(rt_s, ct_s),
-                      numericDisplay(rt_s));
-    }
+    uiUpdateQueue->post(cmd, "roundtime", [=]() {
+        if(clear) {
+            cmd->clearRt();
+        } else {
+            cmd->insertRt(segmentDisplay(rt_s, ct_s),
+                          numericDisplay(rt_s));
+        }
+    });
 }
 
 QPixmap RoundTimeDisplay::segmentDisplay(int rt, int ct) {
     int max = qMax(rt, ct);
     int min = qMin(rt, ct);
 
-    QPixmap collage(RT_SEGMENT_WIDTH * max, 10);
-    collage.fill(Qt::transparent);
-
-    QPainter painter(&collage);
-    if(painter.isActive()) {
-        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    QString key = "rt/segment/" + QString::number(rt) + "/" + QString::number(ct) + "/" +
+            rtColor.name() + "/" + ctColor.name();
 
+    return pixmapAtlas->render(key, QSize(RT_SEGMENT_WIDTH * max, 10), [=](QPainter& painter) {
         painter.setBrush(rtColor);
         painter.setPen(rtColor);
 
@@ -131,28 +141,27 @@ QPixmap RoundTimeDisplay::segmentDisplay(int rt, int ct) {
             painter.drawRect(QRect(x, 4, 25, 4));
             x += RT_SEGMENT_WIDTH;
         }
-    }
-    return collage;
+    });
 }
 
 QPixmap RoundTimeDisplay::numericDisplay(int rt) {
-    QPixmap collage(40, 40);
-    collage.fill(Qt::transparent);
-
-    if(rt < 0) return collage;
+    if(rt < 0) {
+        QPixmap collage(40, 40);
+        collage.fill(Qt::transparent);
+        return collage;
+    }
 
-    QPainter painter(&collage);
-    if(painter.isActive()) {
-        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    QFont font = settings->cmdFont();
+    QString key = "rt/digit/" + QString::number(rt) + "/" + rtColor.name() + "/" + font.key();
 
+    return pixmapAtlas->render(key, QSize(40, 40), [=](QPainter& painter) {
         painter.setBrush(rtColor);
         painter.setPen(rtColor);
-        painter.setFont(settings->cmdFont());
+        painter.setFont(font);
 
         QString text = QString::number(rt);
         painter.drawText(QRect(0, 0, 40, 40), Qt::AlignCenter, text);
-    }
-    return collage;
+    });
 }
 
 int RoundTimeDisplay::toSeconds(int ms) {
@@ -161,10 +170,12 @@ int RoundTimeDisplay::toSeconds(int ms) {
 
 void RoundTimeDisplay::setRtColor(QColor color) {
     this->rtColor = color;
+    uiUpdateQueue->invalidate("roundtime");
 }
 
 void RoundTimeDisplay::setCtColor(QColor color) {
     this->ctColor = color;
+    uiUpdateQueue->invalidate("roundtime");
 }
 
 RoundTimeDisplay::~RoundTimeDisplay() {
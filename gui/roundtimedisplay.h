@@ -7,6 +7,8 @@
 class MainWindow;
 class GameDataContainer;
 class GeneralSettings;
+class UiUpdateQueue;
+class PixmapAtlas;
 
 class RoundTimeDisplay : public QObject {
     Q_OBJECT
@@ -35,6 +37,8 @@ private:
     QPixmap numericDisplay(int seconds);
 
     GeneralSettings* settings;
+    UiUpdateQueue* uiUpdateQueue;
+    PixmapAtlas* pixmapAtlas;
 
     QColor rtColor;
     QColor ctColor;
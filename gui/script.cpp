@@ -1,11 +1,21 @@
 #include "script.h"
 
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
 #include "scriptservice.h"
 #include "clientsettings.h"
 #include "defaultvalues.h"
 
-Script::Script(QObject *parent) : QObject(parent), script_proc(new QProcess(this)) {
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+Script::Script(int id, QObject *parent) : QObject(parent), script_proc(new QProcess(this)) {
     scriptService = (ScriptService*)parent;
+    this->id = id;
     clientSettings = ClientSettings::getInstance();
 
     connect(script_proc, SIGNAL(readyReadStandardOutput()), this, SLOT(displayOutputMsg()));
@@ -14,7 +24,13 @@ Script::Script(QObject *parent) : QObject(parent), script_proc(new QProcess(this
     connect(script_proc, SIGNAL(finished(int)), this, SLOT(finish(int)));
     connect(script_proc, SIGNAL(errorOccurred(QProcess::ProcessError)), this, SLOT(handleError(QProcess::ProcessError)));
 
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(SCRIPT_FLUSH_INTERVAL);
+    connect(&flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+
     running = false;
+    terminating = false;
+    warm = false;
 }
 
 bool Script::isRunning() {
@@ -26,37 +42,151 @@ QString Script::currentFileName() {
     return this->fileName;
 }
 
-void Script::execute(QString fileName, QList<QString> userArgs) {   
+int Script::getId() {
+    return this->id;
+}
+
+qint64 Script::elapsed() {
+    return timer.isValid() ? timer.elapsed() : 0;
+}
+
+/* user and system time of the script process in ms, -1 when not available */
+qint64 Script::cpuTime() {
+#ifdef Q_OS_LINUX
+    QFile stat("/proc/" + QString::number(script_proc->processId()) + "/stat");
+    if(!stat.open(QIODevice::ReadOnly)) return -1;
+    // fields after the command name, which may itself contain spaces
+    QByteArray data = stat.readAll();
+    QList<QByteArray> fields = data.mid(data.lastIndexOf(')') + 2).split(' ');
+    if(fields.size() < 13) return -1;
+    qint64 ticks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+    return ticks * 1000 / sysconf(_SC_CLK_TCK);
+#else
+    return -1;
+#endif
+}
+
+qint64 Script::pendingInput() {
+    return writeBuffer.size() + script_proc->bytesToWrite();
+}
+
+bool Script::isTerminating() {
+    return this->terminating;
+}
+
+void Script::setTerminating(bool terminating) {
+    this->terminating = terminating;
+}
+
+QSet<QString>* Script::getSubscriptions() {
+    return &subscriptions;
+}
+
+void Script::loadSettings() {
     path = clientSettings->getQStringNotBlank("Script/scriptEntry", SCRIPT_ENTRY);
     rubyPath = clientSettings->getQStringNotBlank("Script/interpreterPath", SCRIPT_INTERPRETER);
     ext = clientSettings->getQStringNotBlank("Script/fileExtension", SCRIPT_FILE_EXTENSION);
     scriptPath = clientSettings->getQStringNotBlank("Script/scriptPath", SCRIPT_PATH);
+}
 
-    QString file = scriptPath + fileName + ext;
+void Script::reset(QString fileName) {
     this->fileName = fileName;
 
+    writeBuffer.clear();
+    readBuffer.clear();
+    this->clearCommands();
+    subscriptions.clear();
+    terminating = false;
+    timer.start();
+}
+
+void Script::execute(QString fileName, QList<QString> userArgs) {   
+    this->loadSettings();
+
+    QString file = scriptPath + fileName + ext;
+    this->reset(fileName);
+
     QStringList arguments;
     arguments << path << file << userArgs;
 
     script_proc->start(rubyPath, arguments, QProcess::Unbuffered | QProcess::ReadWrite);
 }
 
+/* starts the interpreter ahead of time; it loads the script library,
+ * connects to the api server and waits for run() to name the script */
+void Script::prestart() {
+    this->loadSettings();
+    warm = true;
+
+    QStringList arguments;
+    arguments << path << SCRIPT_WARM_ARG;
+
+    script_proc->start(rubyPath, arguments, QProcess::Unbuffered | QProcess::ReadWrite);
+}
+
+bool Script::run(QString fileName, QList<QString> userArgs) {
+    // interpreter settings changed since the process was started
+    if(!warm || !this->isRunning() ||
+            path != clientSettings->getQStringNotBlank("Script/scriptEntry", SCRIPT_ENTRY) ||
+            rubyPath != clientSettings->getQStringNotBlank("Script/interpreterPath", SCRIPT_INTERPRETER)) {
+        return false;
+    }
+    warm = false;
+    ext = clientSettings->getQStringNotBlank("Script/fileExtension", SCRIPT_FILE_EXTENSION);
+    scriptPath = clientSettings->getQStringNotBlank("Script/scriptPath", SCRIPT_PATH);
+
+    this->reset(fileName);
+
+    QJsonObject run;
+    run.insert("file", scriptPath + fileName + ext);
+    run.insert("args", QJsonArray::fromStringList(userArgs));
+    this->sendMessage("run#" + QJsonDocument(run).toJson(QJsonDocument::Compact) + "\n");
+    this->flush();
+    return true;
+}
+
+bool Script::isWarm() {
+    return this->warm;
+}
+
 void Script::killScript() {
+    flushTimer.stop();
+    writeBuffer.clear();
     script_proc->kill();
     script_proc->waitForFinished(1000);
 }
 
+/* messages are whole newline terminated lines; they are
+ * collected and written to the process in one call */
 void Script::sendMessage(QByteArray message) {
-    if(script_proc->isOpen() && script_proc->isWritable()) {
-        script_proc->write(message);
+    writeBuffer.append(message);
+    if(writeBuffer.size() >= SCRIPT_WRITE_BUFFER_SIZE) {
+        this->flush();
+    } else if(!flushTimer.isActive()) {
+        flushTimer.start();
+    }
+}
+
+void Script::flush() {
+    flushTimer.stop();
+    if(!writeBuffer.isEmpty() && script_proc->isOpen() && script_proc->isWritable()) {
+        script_proc->write(writeBuffer);
     }
+    writeBuffer.clear();
 }
 
 void Script::displayOutputMsg() {
     script_proc->setReadChannel(QProcess::StandardOutput);
-    QByteArray msg = script_proc->readAll();        
-    scriptService->processCommand(msg);
-    //qDebug() << msg.data();
+    readBuffer.append(script_proc->readAll());
+
+    // only complete lines are dispatched, a partial
+    // command waits for the rest of it in the next read
+    int end = readBuffer.lastIndexOf('\n');
+    if(end < 0) return;
+
+    QByteArray msg = readBuffer.left(end + 1);
+    readBuffer.remove(0, end + 1);
+    scriptService->processCommand(msg, this);
 }
 
 void Script::displayErrorMsg() {
@@ -71,24 +201,34 @@ void Script::start() {
 }
 
 void Script::finish(int exit) {
+    flushTimer.stop();
+    writeBuffer.clear();
     script_proc->closeWriteChannel();
 
-    if(exit == 0) {
-        scriptService->scriptFinished();
+    // output left unread and a last command without a trailing newline
+    readBuffer.append(script_proc->readAllStandardOutput());
+    if(!readBuffer.isEmpty()) {
+        scriptService->processCommand(readBuffer, this);
+        readBuffer.clear();
+    }
+
+    if(exit == 0 && !warm) {
+        scriptService->scriptFinished(this);
     }
-    scriptService->scriptEnded();    
+    scriptService->scriptEnded(this);
 }
 
 void Script::handleError(QProcess::ProcessError error) {
-    if (error == QProcess::FailedToStart) {
+    // an idle pooled interpreter goes away quietly
+    if (error == QProcess::FailedToStart && !warm) {
         scriptService->writeGameWindow("The script process failed to start. "
                                        "Either the Ruby installation is missing, "
                                        "or you may have insufficient permissions to "
                                        "invoke Ruby installation.");
     }
-    scriptService->scriptEnded();
-
     running = false;
+
+    scriptService->scriptEnded(this);
 }
 
 Script::~Script() {
@@ -7,21 +7,39 @@
 #include <QDir>
 #include <QMutex>
 #include <QReadWriteLock>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSet>
+
+#include "scriptcommandqueue.h"
 
 class ScriptService;
 class ClientSettings;
 
-class Script : public QObject {
+class Script : public QObject, public ScriptCommandQueue {
     Q_OBJECT
 
 public:
-    Script(QObject *parent = 0);
+    Script(int id, QObject *parent = 0);
     ~Script();
 
     void execute(QString, QList<QString>);
+    void prestart();
+    bool run(QString, QList<QString>);
+    bool isWarm();
 
     bool isRunning();  
     QString currentFileName();
+    int getId();
+
+    qint64 elapsed();
+    qint64 cpuTime();
+    qint64 pendingInput();
+
+    bool isTerminating();
+    void setTerminating(bool terminating);
+
+    QSet<QString>* getSubscriptions();
 
 private:
     ScriptService* scriptService;
@@ -35,11 +53,24 @@ private:
     QString ext;
     QString fileName;    
 
+    int id;
+    bool warm;
     bool running;
+    bool terminating;
+
+    QElapsedTimer timer;
+    QSet<QString> subscriptions;
+
+    QByteArray writeBuffer;
+    QByteArray readBuffer;
+    QTimer flushTimer;
 
     QMutex procMutex;
     QReadWriteLock lock;
 
+    void loadSettings();
+    void reset(QString fileName);
+
 signals:
 
 public slots:
@@ -47,6 +78,7 @@ public slots:
     void sendMessage(QByteArray);
 
 private slots:
+    void flush();
     void displayOutputMsg();
     void displayErrorMsg();
     void start();
@@ -13,8 +13,15 @@
 #include "textutils.h"
 #include "maps/mapfacade.h"
 #include "scriptservice.h"
+#include "maps/roomnode.h"
+#include "defaultvalues.h"
 
-ScriptApiServer::ScriptApiServer(QObject *parent) : QObject(parent), networkSession(0) {
+#include <QtEndian>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+ScriptApiServer::ScriptApiServer(QObject *parent) : QObject(NULL), tcpServer(0), localServer(0), networkSession(0) {
     mainWindow = (MainWindow*)parent;
     windowFacade = mainWindow->getWindowFacade();
 
@@ -25,31 +32,62 @@ ScriptApiServer::ScriptApiServer(QObject *parent) : QObject(parent), networkSess
 
     tray = mainWindow->getTray();
 
+    // gui objects are only reached through queued signals from the api thread
     connect(this, SIGNAL(track(QString)), expWindow, SLOT(track(QString)));
     connect(this, SIGNAL(clearTracked()), expWindow, SLOT(clearTracked()));
 
-    connect(this, SIGNAL(windowNames()), windowFacade, SLOT(getStreamWindowNames()));
     connect(this, SIGNAL(addWindow(QString, QString)), windowFacade, SLOT(registerStreamWindow(QString, QString)));
     connect(this, SIGNAL(removeWindow(QString)), windowFacade, SLOT(removeStreamWindow(QString)));
     connect(this, SIGNAL(clearWindow(QString)), windowFacade, SLOT(clearStreamWindow(QString)));
     connect(this, SIGNAL(writeWindow(QString, QString)), windowFacade, SLOT(writeStreamWindow(QString, QString)));
     connect(this, SIGNAL(writeTray(QString, QString)), tray, SLOT(showMessage(QString, QString)));
 
+    ScriptService* scriptService = mainWindow->getScriptService();
+    connect(this, &ScriptApiServer::processCommand, scriptService, [scriptService](QByteArray command) {
+        scriptService->processCommand(command);
+    });
+    TcpClient* client = tcpClient;
+    connect(this, &ScriptApiServer::connectClient, tcpClient, [client](QStringList args) {
+        client->connectApi(args.at(0), args.at(1), args.at(2), args.at(3),
+            args.at(4), args.at(5), TextUtils::toBool(args.at(6)));
+    });
+
+    qRegisterMetaType<QList<QString> >("QList<QString>");
+
     data = GameDataContainer::Instance();    
 
     apiSettings = new ApiSettings();
     clientSettings = ClientSettings::getInstance();
 
-    this->initNetworkSession();
+    this->registerHandlers();
+
+    // sockets and request handling live on their own thread
+    apiThread = new QThread(parent);
+    this->moveToThread(apiThread);
+    connect(apiThread, SIGNAL(started()), this, SLOT(initNetworkSession()));
+    connect(apiThread, SIGNAL(finished()), this, SLOT(deleteLater()));
+    apiThread->start();
+}
+
+void ScriptApiServer::stop() {
+    // the server is deleted on its own thread once the event loop exits
+    QThread* serverThread = apiThread;
+    serverThread->quit();
+    serverThread->wait();
 }
 
 void ScriptApiServer::reloadSettings() {
+    if(QThread::currentThread() != apiThread) {
+        QMetaObject::invokeMethod(this, "reloadSettings", Qt::QueuedConnection);
+        return;
+    }
     clientSettings = ClientSettings::getInstance();
     this->openSession();
 }
 
 void ScriptApiServer::initNetworkSession() {
     tcpServer = new QTcpServer(this);
+    localServer = new QLocalServer(this);
     QNetworkConfigurationManager manager;
     if (manager.capabilities() & QNetworkConfigurationManager::NetworkSessionRequired) {
         networkSession = new QNetworkSession(manager.defaultConfiguration(), this);
@@ -59,9 +97,12 @@ void ScriptApiServer::initNetworkSession() {
         openSession();
     }
     connect(tcpServer, SIGNAL(newConnection()), this, SLOT(newConnection()));
+    connect(localServer, SIGNAL(newConnection()), this, SLOT(newLocalConnection()));
 }
 
 void ScriptApiServer::openSession() {
+    this->openLocalSession();
+
     if(tcpServer->isListening()) tcpServer->close();
     if (!tcpServer->listen(QHostAddress::LocalHost, clientSettings->getParameter("Script/apiPort", 0).toInt())) {
         Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))->
@@ -71,6 +112,24 @@ void ScriptApiServer::openSession() {
     apiSettings->setParameter("ApiServer/port", tcpServer->serverPort());
 }
 
+/* unix domain socket next to the tcp port; scripts prefer it when advertised in api.ini */
+void ScriptApiServer::openLocalSession() {
+    if(localServer->isListening()) localServer->close();
+    apiSettings->setParameter("ApiServer/socket", "");
+
+    if(!clientSettings->getParameter("Script/localSocketEnabled", SCRIPT_LOCAL_SOCKET_ENABLED).toBool()) return;
+
+    QString name = SCRIPT_LOCAL_SOCKET("api");
+    QLocalServer::removeServer(name);
+    localServer->setSocketOptions(QLocalServer::UserAccessOption);
+    if(!localServer->listen(name)) {
+        Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))->
+                info("Unable to start local API server" + localServer->errorString());
+        return;
+    }
+    apiSettings->setParameter("ApiServer/socket", localServer->fullServerName());
+}
+
 void ScriptApiServer::newConnection() {
     QTcpSocket *clientConnection = tcpServer->nextPendingConnection();
     clientConnection->setSocketOption(QAbstractSocket::LowDelayOption, 1);
@@ -79,200 +138,227 @@ void ScriptApiServer::newConnection() {
     connect(clientConnection, SIGNAL(readyRead()), this, SLOT(readyRead()));
 }
 
+void ScriptApiServer::newLocalConnection() {
+    QLocalSocket *clientConnection = localServer->nextPendingConnection();
+
+    connect(clientConnection, SIGNAL(disconnected()), clientConnection, SLOT(deleteLater()));
+    connect(clientConnection, SIGNAL(readyRead()), this, SLOT(readyRead()));
+}
+
 void ScriptApiServer::readyRead() {
-    QTcpSocket *socket = (QTcpSocket*) sender();
-    while (socket->canReadLine()) {
+    QIODevice *socket = qobject_cast<QIODevice*>(sender());
+
+    // replies to pipelined requests are sent back in one write
+    QByteArray out;
+    while (socket->property(PROTOCOL_PROPERTY).toInt() < 2 && socket->canReadLine()) {
         QString line = QString::fromUtf8(socket->readLine()).trimmed();
-        if(line.startsWith("GET")) {
-            ApiRequest request = parseRequest(line.mid(3).trimmed());
-            if(request.name == "CHAR_NAME") {
-                this->write(socket, tr("%1\\0").arg(data->getCharName()));                                
-            } else if(request.name == "EXP_RANK") {
-                this->write(socket, tr("%1\\0").arg(data->getExp(request.args.at(0)).value("rank")));
-            } else if(request.name == "EXP_STATE") {
-                this->write(socket, tr("%1\\0").arg(data->getExp(request.args.at(0)).value("state")));
-            } else if(request.name == "ACTIVE_SPELLS") {
-                this->write(socket, tr("%1\\0").arg(data->getActiveSpells().join("\n")));
-            } else if(request.name == "INVENTORY") {
-                this->write(socket, tr("%1\\0").arg(data->getInventory().join("\n")));
-            } else if(request.name == "CONTAINER") {
-                this->write(socket, tr("%1\\0").arg(data->getContainer().join("\n")));
-            } else if(request.name == "WIELD_RIGHT") {
-                this->write(socket, tr("%1\\0").arg(data->getRight()));
-            } else if(request.name == "WIELD_RIGHT_NOUN") {
-                this->write(socket, tr("%1\\0").arg(data->getRightNoun()));
-            } else if(request.name == "WIELD_LEFT") {
-                this->write(socket, tr("%1\\0").arg(data->getLeft()));
-            } else if(request.name == "WIELD_LEFT_NOUN") {
-                this->write(socket, tr("%1\\0").arg(data->getLeftNoun()));
-            } else if(request.name == "HEALTH") {
-                this->write(socket, tr("%1\\0").arg(data->getHealth()));
-            } else if(request.name == "CONCENTRATION") {
-                this->write(socket, tr("%1\\0").arg(data->getConcentration()));
-            } else if(request.name == "SPIRIT") {
-                this->write(socket, tr("%1\\0").arg(data->getSpirit()));
-            } else if(request.name == "FATIGUE") {
-                this->write(socket, tr("%1\\0").arg(data->getFatigue()));
-            } else if(request.name == "STANDING") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getStanding())));
-            } else if(request.name == "SITTING") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getSitting())));
-            } else if(request.name == "KNEELING") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getKneeling())));
-            } else if(request.name == "PRONE") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getProne())));
-            } else if(request.name == "STUNNED") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getStunned())));
-            } else if(request.name == "BLEEDING") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getBleeding())));
-            } else if(request.name == "HIDDEN") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getHidden())));
-            } else if(request.name == "INVISIBLE") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getInvisible())));
-            } else if(request.name == "WEBBED") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getWebbed())));
-            } else if(request.name == "JOINED") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getJoined())));
-            } else if(request.name == "DEAD") {
-                this->write(socket, tr("%1\\0").arg(boolToInt(data->getDead())));
-            } else if(request.name == "ROOM_TITLE") {
-                this->write(socket, tr("%1\\0").arg(data->getRoomName()));
-            } else if(request.name == "ROOM_DESC") {
-                this->write(socket, tr("%1\\0").arg(data->getRoomDesc()));
-            } else if(request.name == "ROOM_OBJECTS") {
-                this->write(socket, tr("%1\\0").arg(data->getRoomObjs()));
-            } else if(request.name == "ROOM_PLAYERS") {
-                this->write(socket, tr("%1\\0").arg(data->getRoomPlayers()));
-            } else if(request.name == "ROOM_EXITS") {
-                this->write(socket, tr("%1\\0").arg(data->getRoomExits()));
-            } else if(request.name == "RT") {
-                this->write(socket, tr("%1\\0").arg(data->getRt()));
-            } else if(request.name == "CT") {
-                this->write(socket, tr("%1\\0").arg(data->getCt()));
-            } else if(request.name == "EXP_NAMES") {
-                this->write(socket, tr("%1\\0").arg(data->getExp().keys().join("\n")));
-            } else if(request.name == "ROOM_MONSTERS_BOLD") {
-                this->write(socket, tr("%1\\0").arg(data->getRoomMonstersBold().join("\n")));
-            } else {
-                this->write(socket, tr("\\0"));
-            }
-        } else if(line.startsWith("MAP_GET")) {
-            ApiRequest request = parseRequest(line.mid(7).trimmed());
-            if(request.name == "PATH") {
-                QStringList args = request.args;
-                if(args.size() < 3) {
-                    this->write(socket, tr("\\0"));
-                } else {
-                    QString path = mapData->findPath(args.at(0), args.at(1).toInt(), args.at(2).toInt());
-                    this->write(socket, tr("%1\\0").arg(path));
-                }
-            } else if(request.name == "CURRENT_ROOM") {
-                RoomNode room = mapData->getRoom();
-                this->write(socket, QString("{:zone => '%1', :level => %2, :id => %3}\\0")
-                            .arg(room.getZoneId(), QString::number(room.getLevel()), QString::number(room.getNodeId())));
-            } else if(request.name == "ZONES") {
-                this->write(socket, tr("%1\\0").arg(mapData->getZones()));                
-            } else if(request.name == "FIND_ROOM") {
-                QStringList args = request.args;
-                if(args.size() < 1) {
-                    this->write(socket, tr("\\0"));
-                } else {
-                    RoomNode room = mapData->findLocation(args.at(0));
-                    this->write(socket, QString("{:zone => '%1', :level => %2, :id => %3}\\0")
-                                .arg(room.getZoneId(), QString::number(room.getLevel()), QString::number(room.getNodeId())));
-                }
-            } else {
-                this->write(socket, tr("\\0"));
-            }
-        } else if(line.startsWith("CLIENT")) {
-            ApiRequest request = parseRequest(line.mid(6).trimmed());
-            if(request.name == "CONNECT") {
-                QStringList args = request.args;
-                if(args.size() < 7) {
-                    this->write(socket, tr("0\\0"));
-                } else {
-                    tcpClient->connectApi(args.at(0), args.at(1), args.at(2), args.at(3),
-                        args.at(4), args.at(5), TextUtils::toBool(args.at(6)));
-                    this->write(socket, tr("1\\0"));
-                }
-            } else if(request.name == "TRACK_EXP") {
-                QStringList args = request.args;
-                if(args.size() < 1) {
-                    this->write(socket, tr("0\\0"));
-                } else {
-                    emit track(args.at(0));
-                    this->write(socket, tr("1\\0"));
-                }
-            } else if(request.name == "TRACK_EXP_CLEAR") {
-                emit clearTracked();
-                this->write(socket, tr("\\0"));
-            } else if(request.name == "WINDOW_LIST") {
-                QList<QString> list = emit windowNames();
-                this->write(socket, tr("%1\\0").arg(list.join("\n")));
-            } else if(request.name == "WINDOW_ADD") {
-                QStringList args = request.args;
-                if(args.size() == 2) {
-                    emit addWindow(args.at(0), args.at(1));
-                    this->write(socket, tr("1\\0"));
-                } else {
-                    this->write(socket, tr("0\\0"));
-                }
-            } else if(request.name == "WINDOW_REMOVE") {
-                QStringList args = request.args;
-                if(args.size() == 1) {
-                    emit removeWindow(args.at(0));
-                    this->write(socket, tr("1\\0"));
-                } else {
-                    this->write(socket, tr("0\\0"));
-                }
-            } else if(request.name == "WINDOW_CLEAR") {
-                QStringList args = request.args;
-                if(args.size() == 1) {
-                    emit clearWindow(args.at(0));
-                    this->write(socket, tr("1\\0"));
-                } else {
-                    this->write(socket, tr("0\\0"));
-                }
-            } else if(request.name == "WINDOW_WRITE") {
-                QStringList args = request.args;
-                if(args.size() == 2) {
-                    emit writeWindow(args.at(0), args.at(1));
-                    this->write(socket, tr("1\\0"));
-                } else {
-                    this->write(socket, tr("0\\0"));
-                }
-            } else if(request.name == "TRAY_WRITE") {
-                QStringList args = request.args;
-                if(args.size() == 1) {
-                    emit writeTray("Script", args.at(0));
-                    this->write(socket, tr("1\\0"));
-                } else {
-                    this->write(socket, tr("0\\0"));
-                }
-            }
-        } else if(line.startsWith("PUT")) {
-            ApiRequest request = parseRequest(line.mid(strlen("PUT")).trimmed());
-            QString message = request.args.join(" ");
-            // send the command to the ScriptService to execute
-            // prepending with prefixes as it is coming from the script
-            if(request.name == "COMMAND") {
-                mainWindow->getScriptService()->processCommand(("put#" + message).toLatin1());
-                this->write(socket, tr("1\\0"));
-            } else if (request.name == "ECHO") {
-                mainWindow->getScriptService()->processCommand(("echo#" + message).toLatin1());
-                this->write(socket, tr("1\\0"));
-            } else {            // unknown command
-                this->write(socket, tr("0\\0"));
-            }
-        } else {
-            this->write(socket, tr("\\0"));
+        if(line.startsWith("PROTOCOL")) {
+            int version = line.mid(strlen("PROTOCOL")).trimmed().toInt();
+            if(version == 2) socket->setProperty(PROTOCOL_PROPERTY, version);
+            out.append(reply(QString::number(version == 2 ? 2 : 1)).toLocal8Bit());
+            continue;
+        }
+        QString response = this->handleLine(line);
+        if(!response.isNull()) out.append(response.toLocal8Bit());
+    }
+
+    if(socket->property(PROTOCOL_PROPERTY).toInt() == 2) {
+        this->readFrames(socket, out);
+    }
+
+    if(!out.isEmpty()) {
+        socket->write(out);
+        this->flush(socket);
+    }
+}
+
+void ScriptApiServer::flush(QIODevice *socket) {
+    if(QAbstractSocket* tcpSocket = qobject_cast<QAbstractSocket*>(socket)) {
+        tcpSocket->flush();
+    } else if(QLocalSocket* localSocket = qobject_cast<QLocalSocket*>(socket)) {
+        localSocket->flush();
+    }
+}
+
+/*
+ * Protocol 2 frame, both directions:
+ *   quint32 length (big endian, bytes following this field)
+ *   quint32 request id (big endian, echoed back in the reply)
+ *   compact json object
+ *
+ * Requests: {"get": ["RT", "HEALTH", "EXP_RANK?climbing"]} reads all fields under
+ * one lock and replies {"RT": 0, "HEALTH": 100, ...}; {"call": "MAP_GET ZONES"}
+ * runs any text protocol line and replies {"result": "..."}.
+ */
+void ScriptApiServer::readFrames(QIODevice *socket, QByteArray& out) {
+    while(socket->bytesAvailable() >= FRAME_HEADER_SIZE) {
+        QByteArray header = socket->peek(FRAME_HEADER_SIZE);
+        quint32 length = qFromBigEndian<quint32>((const uchar*)header.constData());
+        if(length < sizeof(quint32) || length > MAX_FRAME_SIZE) {
+            socket->close();
+            return;
         }
+        if(socket->bytesAvailable() < (qint64)(sizeof(quint32) + length)) return;
+
+        socket->read(sizeof(quint32));
+        QByteArray frame = socket->read(length);
+        quint32 id = qFromBigEndian<quint32>((const uchar*)frame.constData());
+
+        QJsonObject request = QJsonDocument::fromJson(frame.mid(sizeof(quint32))).object();
+        out.append(this->frame(id, this->handleFrame(request)));
+    }
+}
+
+QJsonObject ScriptApiServer::handleFrame(const QJsonObject& request) {
+    QJsonObject reply;
+    if(request.contains("get")) {
+        QStringList fields;
+        foreach(const QJsonValue& value, request.value("get").toArray()) {
+            fields << value.toString();
+        }
+        reply = QJsonObject::fromVariantMap(data->snapshot(fields));
+    } else if(request.contains("call")) {
+        QString result = this->handleLine(request.value("call").toString());
+        if(result.endsWith("\\0")) result.chop(2);
+        reply.insert("result", result);
+    }
+    return reply;
+}
+
+QByteArray ScriptApiServer::frame(quint32 id, const QJsonObject& reply) {
+    QByteArray payload = QJsonDocument(reply).toJson(QJsonDocument::Compact);
+
+    QByteArray frame(FRAME_HEADER_SIZE, Qt::Uninitialized);
+    qToBigEndian<quint32>(sizeof(quint32) + payload.size(), (uchar*)frame.data());
+    qToBigEndian<quint32>(id, (uchar*)frame.data() + sizeof(quint32));
+    frame.append(payload);
+    return frame;
+}
+
+QString ScriptApiServer::reply(const QString& value) {
+    return value + "\\0";
+}
+
+QString ScriptApiServer::reply(const QVariant& value) {
+    if(value.type() == QVariant::Bool) {
+        return reply(QString::number(boolToInt(value.toBool())));
+    } else if(value.type() == QVariant::StringList) {
+        return reply(value.toStringList().join("\n"));
     }
+    return reply(value.toString());
+}
+
+QString ScriptApiServer::roomReply(const RoomNode& room) {
+    return reply(QString("{:zone => '%1', :level => %2, :id => %3}")
+        .arg(room.getZoneId(), QString::number(room.getLevel()), QString::number(room.getNodeId())));
 }
 
-void ScriptApiServer::write(QTcpSocket *socket, QString value) {
-    socket->write(value.toLocal8Bit());
-    socket->flush();
+void ScriptApiServer::registerHandlers() {
+    handlers.insert("MAP_GET PATH", [this](const ApiRequest& request) {
+        if(request.args.size() < 3) return reply(QString());
+        return reply(mapData->findPath(request.args.at(0), request.args.at(1).toInt(), request.args.at(2).toInt()));
+    });
+    // ROUTE?<location note> or ROUTE?<zone>&<room id>, starting from the current room
+    handlers.insert("MAP_GET ROUTE", [this](const ApiRequest& request) {
+        if(request.args.size() == 1) {
+            RoomNode room = mapData->findLocation(request.args.at(0));
+            return reply(mapData->findRoute(room.getZoneId(), room.getNodeId()));
+        } else if(request.args.size() == 2) {
+            return reply(mapData->findRoute(request.args.at(0), request.args.at(1).toInt()));
+        }
+        return reply(QString());
+    });
+    handlers.insert("MAP_GET CURRENT_ROOM", [this](const ApiRequest&) {
+        return roomReply(mapData->getRoom());
+    });
+    handlers.insert("MAP_GET ZONES", [this](const ApiRequest&) {
+        return reply(mapData->getZones());
+    });
+    handlers.insert("MAP_GET FIND_ROOM", [this](const ApiRequest& request) {
+        if(request.args.size() < 1) return reply(QString());
+        return roomReply(mapData->findLocation(request.args.at(0)));
+    });
+
+    handlers.insert("CLIENT CONNECT", [this](const ApiRequest& request) {
+        if(request.args.size() < 7) return reply(QString("0"));
+        emit connectClient(request.args);
+        return reply(QString("1"));
+    });
+    handlers.insert("CLIENT TRACK_EXP", [this](const ApiRequest& request) {
+        if(request.args.size() < 1) return reply(QString("0"));
+        emit track(request.args.at(0));
+        return reply(QString("1"));
+    });
+    handlers.insert("CLIENT TRACK_EXP_CLEAR", [this](const ApiRequest&) {
+        emit clearTracked();
+        return reply(QString());
+    });
+    handlers.insert("CLIENT WINDOW_LIST", [this](const ApiRequest&) {
+        return reply(QStringList(windowFacade->getStreamWindowNames()).join("\n"));
+    });
+    handlers.insert("CLIENT WINDOW_ADD", [this](const ApiRequest& request) {
+        if(request.args.size() != 2) return reply(QString("0"));
+        windowFacade->addStreamWindowName(request.args.at(0));
+        emit addWindow(request.args.at(0), request.args.at(1));
+        return reply(QString("1"));
+    });
+    handlers.insert("CLIENT WINDOW_REMOVE", [this](const ApiRequest& request) {
+        if(request.args.size() != 1) return reply(QString("0"));
+        windowFacade->removeStreamWindowName(request.args.at(0));
+        emit removeWindow(request.args.at(0));
+        return reply(QString("1"));
+    });
+    handlers.insert("CLIENT WINDOW_CLEAR", [this](const ApiRequest& request) {
+        if(request.args.size() != 1) return reply(QString("0"));
+        emit clearWindow(request.args.at(0));
+        return reply(QString("1"));
+    });
+    handlers.insert("CLIENT WINDOW_WRITE", [this](const ApiRequest& request) {
+        if(request.args.size() != 2) return reply(QString("0"));
+        emit writeWindow(request.args.at(0), request.args.at(1));
+        return reply(QString("1"));
+    });
+    handlers.insert("CLIENT TRAY_WRITE", [this](const ApiRequest& request) {
+        if(request.args.size() != 1) return reply(QString("0"));
+        emit writeTray("Script", request.args.at(0));
+        return reply(QString("1"));
+    });
+
+    // send the command to the ScriptService to execute
+    // prepending with prefixes as it is coming from the script
+    handlers.insert("PUT COMMAND", [this](const ApiRequest& request) {
+        emit processCommand(("put#" + request.args.join(" ")).toLatin1());
+        return reply(QString("1"));
+    });
+    handlers.insert("PUT ECHO", [this](const ApiRequest& request) {
+        emit processCommand(("echo#" + request.args.join(" ")).toLatin1());
+        return reply(QString("1"));
+    });
+}
+
+QString ScriptApiServer::handleLine(const QString& line) {
+    int index = line.indexOf(' ');
+    QString method = index > -1 ? line.left(index) : line;
+    ApiRequest request = parseRequest(index > -1 ? line.mid(index + 1).trimmed() : QString());
+
+    if(method == "GET") {
+        // plain reads go straight to the game data, no handler needed
+        QString field = request.args.isEmpty() ? request.name : request.name + "?" + request.args.join("&");
+        return reply(data->get(field));
+    }
+
+    QHash<QString, ApiHandler>::const_iterator handler = handlers.constFind(method + " " + request.name);
+    if(handler != handlers.constEnd()) {
+        return handler.value()(request);
+    }
+
+    // unknown requests
+    if(method == "CLIENT") {
+        return QString();
+    } else if(method == "PUT") {
+        return reply(QString("0"));
+    }
+    return reply(QString());
 }
 
 ApiRequest ScriptApiServer::parseRequest(QString reqString) {
@@ -5,6 +5,13 @@
 #include <QStringList>
 
 #include <QtNetwork>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonObject>
+#include <QHash>
+#include <QThread>
+
+#include <functional>
 
 #include "log4qt/logger.h"
 
@@ -13,7 +20,10 @@ struct ApiRequest {
     QStringList args;
 };
 
+typedef std::function<QString(const ApiRequest&)> ApiHandler;
+
 class MapData;
+class RoomNode;
 class TcpClient;
 class GridWindow;
 class Tray;
@@ -23,6 +33,10 @@ class WindowFacade;
 class ApiSettings;
 class ClientSettings;
 
+#define PROTOCOL_PROPERTY "apiProtocol"
+#define FRAME_HEADER_SIZE 8
+#define MAX_FRAME_SIZE 1048576
+
 class ScriptApiServer : public QObject {
     Q_OBJECT
 
@@ -30,14 +44,27 @@ public:
     explicit ScriptApiServer(QObject *parent = 0);
     ~ScriptApiServer();
 
+    void stop();
+
     QTcpServer *tcpServer;
+    QLocalServer *localServer;
     QNetworkSession *networkSession;
 
 private:
     ApiRequest parseRequest(QString reqString);
-    void write(QTcpSocket *socket, QString value);
+    QString handleLine(const QString& line);
+    void registerHandlers();
+
+    QString reply(const QString& value);
+    QString reply(const QVariant& value);
+    QString roomReply(const RoomNode& room);
+
+    void readFrames(QIODevice *socket, QByteArray& out);
+    void flush(QIODevice *socket);
+    void openLocalSession();
+    QJsonObject handleFrame(const QJsonObject& request);
+    QByteArray frame(quint32 id, const QJsonObject& reply);
     int boolToInt(bool value);
-    void initNetworkSession();
 
     GameDataContainer* data;
     ApiSettings* apiSettings;
@@ -52,20 +79,26 @@ private:
 
     Tray* tray;
 
+    QThread* apiThread;
+    QHash<QString, ApiHandler> handlers;
+
 signals:
     void track(QString);
     void clearTracked();       
-    QList<QString> windowNames();
 
     void addWindow(QString, QString);
     void removeWindow(QString);
     void clearWindow(QString);
     void writeWindow(QString, QString);
     void writeTray(QString, QString);
+    void connectClient(QStringList);
+    void processCommand(QByteArray);
 
 public slots:
+        void initNetworkSession();
         void reloadSettings();
         void newConnection();
+        void newLocalConnection();
         void openSession();
         void readyRead();
 };
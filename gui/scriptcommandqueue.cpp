@@ -0,0 +1,36 @@
+#include "scriptcommandqueue.h"
+
+ScriptCommandQueue::ScriptCommandQueue() {
+    priority = 0;
+}
+
+int ScriptCommandQueue::getPriority() {
+    return this->priority;
+}
+
+void ScriptCommandQueue::setPriority(int priority) {
+    this->priority = priority;
+}
+
+void ScriptCommandQueue::enqueueCommand(QByteArray command) {
+    commands.enqueue(command);
+}
+
+bool ScriptCommandQueue::hasCommands() {
+    return !commands.isEmpty();
+}
+
+QByteArray ScriptCommandQueue::takeCommand() {
+    return commands.dequeue();
+}
+
+int ScriptCommandQueue::pendingCommands() {
+    return commands.size();
+}
+
+void ScriptCommandQueue::clearCommands() {
+    commands.clear();
+}
+
+ScriptCommandQueue::~ScriptCommandQueue() {
+}
@@ -0,0 +1,30 @@
+#ifndef SCRIPTCOMMANDQUEUE_H
+#define SCRIPTCOMMANDQUEUE_H
+
+#include <QQueue>
+#include <QByteArray>
+
+/* Commands a script sent and the client has not passed on yet; shared by
+   ruby and javascript scripts so ScriptService can interleave them.
+   Only used on the gui thread. */
+class ScriptCommandQueue {
+
+public:
+    ScriptCommandQueue();
+    virtual ~ScriptCommandQueue();
+
+    int getPriority();
+    void setPriority(int priority);
+
+    void enqueueCommand(QByteArray command);
+    bool hasCommands();
+    QByteArray takeCommand();
+    int pendingCommands();
+    void clearCommands();
+
+private:
+    int priority;
+    QQueue<QByteArray> commands;
+};
+
+#endif // SCRIPTCOMMANDQUEUE_H
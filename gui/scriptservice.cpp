@@ -9,28 +9,163 @@
 #include "defaultvalues.h"
 #include "clientsettings.h"
 #include "scriptstreamserver.h"
+#include "gamedatacontainer.h"
+#include "maps/mapfacade.h"
+#include "js/jsscript.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTimer>
+
+#include <algorithm>
 
 ScriptService::ScriptService(QObject *parent) : QObject(parent) {
     mainWindow = (MainWindow*)parent;
     commandLine = mainWindow->getCommandLine();
     windowFacade = mainWindow->getWindowFacade();
+    data = GameDataContainer::Instance();
+    mapData = windowFacade->getMapFacade()->getData();
     scriptWriter = new ScriptWriterThread(this);
 
-    script = new Script(this);
-    terminateFlag = false;    
+    nextScriptId = 0;
+    dispatchPending = false;
 
     if(!scriptWriter->isRunning()) {
         scriptWriter->start();
     }
 
-    connect(this, SIGNAL(killScript()), script, SLOT(killScript()));
-    connect(this, SIGNAL(sendMessage(QByteArray)), script, SLOT(sendMessage(QByteArray)));
-    connect(scriptWriter, SIGNAL(writeText(QByteArray)),
-            this, SLOT(writeOutgoingMessage(QByteArray)));
+    qRegisterMetaType<QList<int> >("QList<int>");
+
+    connect(scriptWriter, SIGNAL(writeText(QByteArray, QList<int>)),
+            this, SLOT(writeOutgoingMessage(QByteArray, QList<int>)));
+    connect(scriptWriter, SIGNAL(writeMatch(int, QByteArray)),
+            this, SLOT(writeMatchMessage(int, QByteArray)));
+    connect(data, SIGNAL(changed(QString, QVariant)),
+            this, SLOT(stateChanged(QString, QVariant)));
+    connect(&scriptWatcher, SIGNAL(directoryChanged(QString)), this, SLOT(indexScripts()));
+
+    this->indexScripts();
+    // give the client time to open the api server before warming up interpreters
+    QTimer::singleShot(SCRIPT_POOL_DELAY, this, SLOT(fillPool()));
+}
+
+/* script names are looked up in an index kept current by a file watcher
+ * instead of listing the script directory for every command */
+void ScriptService::indexScripts() {
+    QString path = ClientSettings::getInstance()->getQStringNotBlank("Script/scriptPath", SCRIPT_PATH);
+    if(path != indexedPath) {
+        if(!indexedPath.isEmpty()) scriptWatcher.removePath(indexedPath);
+        scriptWatcher.addPath(path);
+        indexedPath = path;
+    }
+
+    QStringList filter;
+    filter << "*.rb" << "*.js";
+
+    QDir myDir(path);
+    scriptIndex = QSet<QString>::fromList(myDir.entryList(filter, QDir::Files, QDir::Name));
+}
+
+bool ScriptService::scriptExists(QString fileName) {
+    return !this->scriptType(fileName).isEmpty();
+}
+
+/* ruby scripts take precedence over javascript ones of the same name */
+QString ScriptService::scriptType(QString fileName) {
+    if(indexedPath != ClientSettings::getInstance()->getQStringNotBlank("Script/scriptPath", SCRIPT_PATH)) {
+        this->indexScripts();
+    }
+    if(scriptIndex.contains(fileName + ".rb")) return "rb";
+    if(scriptIndex.contains(fileName + ".js")) return "js";
+    return QString();
+}
+
+void ScriptService::fillPool() {
+    int size = ClientSettings::getInstance()->getParameter("Script/interpreterPool", SCRIPT_POOL_SIZE).toInt();
+    while(pool.size() < size) {
+        Script* script = new Script(++nextScriptId, this);
+        pool << script;
+        script->prestart();
+    }
+}
+
+void ScriptService::startScript(QString fileName, QList<QString> args) {
+    // hand the script to a warm interpreter when one is ready
+    while(!pool.isEmpty()) {
+        Script* script = pool.takeFirst();
+        if(script->run(fileName, args)) {
+            scripts << script;
+            QTimer::singleShot(0, this, SLOT(fillPool()));
+            return;
+        }
+        script->killScript();
+        script->deleteLater();
+    }
+
+    Script* script = new Script(++nextScriptId, this);
+    scripts << script;
+    script->execute(fileName, args);
+    QTimer::singleShot(0, this, SLOT(fillPool()));
+}
+
+/* javascript runs in process, on a thread of its own per script */
+void ScriptService::startJsScript(QString fileName, QList<QString> args) {
+    JsScript* script = new JsScript(fileName, args, mapData, this);
+    jsScripts << script;
+
+    // the script is the context so nothing queued outlives it
+    connect(script, &JsScript::command, script, [this, script](QString command) {
+        script->enqueueCommand(command.toUtf8());
+        this->scheduleCommands();
+    });
+    connect(script, &JsScript::priorityChanged, script, [script](int priority) {
+        script->setPriority(priority);
+    });
+    WindowFacade* facade = windowFacade;
+    connect(script, &JsScript::echo, this, [facade](QString text) {
+        facade->writeGameWindow("<span class=\"echo\">" + text.toLocal8Bit() + "</span>");
+    });
+    connect(script, &JsScript::error, this, [facade, fileName](QString message) {
+        facade->writeGameWindow("[Script " + fileName.toLocal8Bit() + ".js error: " +
+                                message.toHtmlEscaped().toLocal8Bit() + "]");
+    });
+    connect(script, SIGNAL(addWindow(QString, QString)), windowFacade, SLOT(registerStreamWindow(QString, QString)));
+    connect(script, SIGNAL(removeWindow(QString)), windowFacade, SLOT(removeStreamWindow(QString)));
+    connect(script, SIGNAL(clearWindow(QString)), windowFacade, SLOT(clearStreamWindow(QString)));
+    connect(script, SIGNAL(writeWindow(QString, QString)), windowFacade, SLOT(writeStreamWindow(QString, QString)));
+    connect(script, &JsScript::finished, this, [this, script]() {
+        this->jsScriptEnded(script);
+    });
+    script->start();
 }
 
 bool ScriptService::isScriptActive() {
-    return script->isRunning();
+    foreach (Script* script, scripts) {
+        if(script->isRunning()) return true;
+    }
+    return !jsScripts.isEmpty();
+}
+
+JsScript* ScriptService::findJsScript(QString fileName) {
+    foreach (JsScript* script, jsScripts) {
+        if(script->currentFileName() == fileName) return script;
+    }
+    return NULL;
+}
+
+Script* ScriptService::findScript(QString fileName) {
+    foreach (Script* script, scripts) {
+        if(script->currentFileName() == fileName) return script;
+    }
+    return NULL;
+}
+
+Script* ScriptService::findScript(int id) {
+    foreach (Script* script, scripts) {
+        if(script->getId() == id) return script;
+    }
+    return NULL;
 }
 
 void ScriptService::runScript(QString input) {
@@ -39,25 +174,25 @@ void ScriptService::runScript(QString input) {
     QList<QString> args = input.split(" ");
     QString fileName = args.takeFirst();
 
-    QStringList filter;
-    filter << "*.rb";
-
-    QDir myDir(ClientSettings::getInstance()->getQStringNotBlank("Script/scriptPath", SCRIPT_PATH));
-    QStringList fileList = myDir.entryList(filter, QDir::Files, QDir::Name);
-
-    if(fileList.contains(fileName + ".rb")) {
-        if(!script->isRunning()) {
+    QString type = this->scriptType(fileName);
+    if(!type.isEmpty()) {
+        // different scripts run side by side, the same script only once
+        if(type == "js" && !JS_SCRIPTS_SUPPORTED) {
+            windowFacade->writeGameWindow("[JavaScript scripts need Qt 5.14 or later.]");
+        } else if(findScript(fileName) == NULL && findJsScript(fileName) == NULL) {
             windowFacade->scriptRunning(true);
             windowFacade->writeGameWindow("[Executing script: " +
-                                           fileName.toLocal8Bit() +
-                                           ".rb, Press ESC to abort.]");
-            timer.start();
-            terminateFlag = false;
-            script->execute(fileName, args);
+                                           fileName.toLocal8Bit() + "." + type.toLocal8Bit() +
+                                           ", Press ESC to abort.]");
+            if(type == "js") {
+                this->startJsScript(fileName, args);
+            } else {
+                this->startScript(fileName, args);
+            }
         } else {
             windowFacade->writeGameWindow("[Script " +
-                                           script->currentFileName().toLocal8Bit() +
-                                           ".rb already executing.]");
+                                           fileName.toLocal8Bit() + "." + type.toLocal8Bit() +
+                                           " already executing.]");
         }
     } else {
         windowFacade->writeGameWindow("[Script not found.]");
@@ -65,73 +200,286 @@ void ScriptService::runScript(QString input) {
 }
 
 void ScriptService::terminateScript() {
+    foreach (Script* script, scripts) {
+        this->terminateScript(script);
+    }
+    foreach (JsScript* script, jsScripts) {
+        windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+            ".js terminated after " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() + ".]");
+        script->clearCommands();
+        script->abort();
+    }
+}
+
+void ScriptService::terminateScript(Script* script) {
     if(script->isRunning()) {
-        emit killScript();
-        windowFacade->writeGameWindow("[Script terminated after " +
-            TextUtils::msToMMSS(timer.elapsed()).toLocal8Bit() + ".]");
-        terminateFlag = false;
+        windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+            ".rb terminated after " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() + ".]");
+        script->killScript();
     }
 }
 
 void ScriptService::abortScript() {
+    foreach (Script* script, scripts) {
+        this->abortScript(script);
+    }
+    foreach (JsScript* script, jsScripts) {
+        this->abortScript(script);
+    }
+}
+
+void ScriptService::abortScript(QString fileName) {
+    Script* script = findScript(fileName);
+    JsScript* jsScript = findJsScript(fileName);
+    if(script != NULL) {
+        this->abortScript(script);
+    } else if(jsScript != NULL) {
+        this->abortScript(jsScript);
+    } else {
+        QString type = this->scriptType(fileName);
+        if(!type.isEmpty()) fileName += "." + type;
+        windowFacade->writeGameWindow("[Script " + fileName.toLocal8Bit() + " is not running.]");
+    }
+}
+
+void ScriptService::abortScript(Script* script) {
     if(script->isRunning()) {
-        if(!terminateFlag) {
-            emit sendMessage("exit#\n");
-            windowFacade->writeGameWindow("[Script aborted after " +
-                TextUtils::msToMMSS(timer.elapsed()).toLocal8Bit() + ".]");
-            terminateFlag = true;
+        if(!script->isTerminating()) {
+            script->sendMessage("exit#\n");
+            windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+                ".rb aborted after " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() + ".]");
+            script->setTerminating(true);
         } else {
-            this->terminateScript();
+            this->terminateScript(script);
         }
     }
 }
 
-void ScriptService::scriptFinished() {
-    windowFacade->writeGameWindow("[Script finished, Execution time - " +
-        TextUtils::msToMMSS(timer.elapsed()).toLocal8Bit() + ".]");
-    timer.invalidate();
-    terminateFlag = false;
+/* the engine is interrupted, so this also stops a script busy in its own code */
+void ScriptService::abortScript(JsScript* script) {
+    if(!script->isAborted()) {
+        windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+            ".js aborted after " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() + ".]");
+        script->clearCommands();
+        script->abort();
+    }
+}
+
+void ScriptService::listScripts() {
+    if(scripts.isEmpty() && jsScripts.isEmpty()) {
+        windowFacade->writeGameWindow("[No scripts running.]");
+        return;
+    }
+    foreach (Script* script, scripts) {
+        qint64 cpu = script->cpuTime();
+        windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+            ".rb - running " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() +
+            ", cpu " + (cpu < 0 ? QByteArray("n/a") : QByteArray::number(cpu / 1000.0, 'f', 1) + "s") +
+            ", priority " + QByteArray::number(script->getPriority()) +
+            ", queued " + QByteArray::number(script->pendingCommands()) + " commands / " +
+            QByteArray::number(script->pendingInput()) + " bytes of game text]");
+    }
+    foreach (JsScript* script, jsScripts) {
+        windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+            ".js - running " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() + ", in process" +
+            ", priority " + QByteArray::number(script->getPriority()) +
+            ", queued " + QByteArray::number(script->pendingCommands()) + " commands]");
+    }
 }
 
-void ScriptService::scriptEnded() {
-    windowFacade->scriptRunning(false);
+void ScriptService::scriptFinished(Script* script) {
+    windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+        ".rb finished, Execution time - " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() + ".]");
+}
+
+void ScriptService::scriptEnded(Script* script) {
+    // a pooled interpreter exited before it was used
+    if(pool.removeOne(script)) {
+        script->deleteLater();
+        return;
+    }
+    // finished and errorOccurred may both report the same script
+    if(!scripts.removeOne(script)) return;
+
+    scriptWriter->clearFilter(script->getId());
+    script->deleteLater();
+    windowFacade->scriptRunning(!scripts.isEmpty() || !jsScripts.isEmpty());
+}
+
+void ScriptService::jsScriptEnded(JsScript* script) {
+    if(!jsScripts.contains(script)) return;
+    // commands sent just before the script ended are still queued
+    if(script->hasCommands()) this->dispatchCommands();
+    jsScripts.removeOne(script);
+
+    if(!script->isAborted()) {
+        windowFacade->writeGameWindow("[Script " + script->currentFileName().toLocal8Bit() +
+            ".js finished, Execution time - " + TextUtils::msToMMSS(script->elapsed()).toLocal8Bit() + ".]");
+    }
+    script->deleteLater();
+    windowFacade->scriptRunning(!scripts.isEmpty() || !jsScripts.isEmpty());
 }
 
 void ScriptService::writeGameWindow(QByteArray command) {
     windowFacade->writeGameWindow(command);
 }
 
-void ScriptService::writeScriptText(QByteArray text) {
+void ScriptService::writeScriptText(QByteArray text, bool prompt) {
     if (!text.isEmpty()) {
         // Script Service delivers script text to both streaming
-        // server and the running script
+        // server and the running scripts
         mainWindow->getScriptStreamServer()->writeData(text);
-        if (this->isScriptActive()) {
+        if (!scripts.isEmpty()) {
             scriptWriter->addData(text.data());
         }
+        foreach (JsScript* script, jsScripts) {
+            script->writeText(text, prompt);
+        }
+    }
+}
+
+/* the same buffer is handed to every script, only its reference is copied */
+void ScriptService::writeOutgoingMessage(QByteArray message, QList<int> filtered) {
+    foreach (Script* script, scripts) {
+        if(!filtered.contains(script->getId()) && script->isRunning()) {
+            script->sendMessage(message);
+        }
     }
 }
 
-void ScriptService::writeOutgoingMessage(QByteArray message) {
+void ScriptService::writeMatchMessage(int id, QByteArray message) {
+    Script* script = findScript(id);
     if(script != NULL && script->isRunning()) {
-        emit sendMessage("game_text#" + message + "\n");
+        script->sendMessage(message);
     }
 }
 
-void ScriptService::processCommand(QByteArray msg) {
+void ScriptService::processCommand(QByteArray msg, Script* script) {
     QList<QByteArray> msgLines = msg.trimmed().split('\n');
     foreach (QByteArray line, msgLines) {
         if(!line.isEmpty()){
             if(line.startsWith("put#")) {
-                commandLine->writeCommand(line.mid(4).trimmed(), "script");
+                if(script != NULL) {
+                    script->enqueueCommand(line.mid(4).trimmed());
+                    this->scheduleCommands();
+                } else {
+                    commandLine->writeCommand(line.mid(4).trimmed(), "script");
+                }
             } else if (line.startsWith("echo#")) {
                 windowFacade->writeGameWindow("<span class=\"echo\">" + line.mid(5).trimmed() + "</span>");
+            } else if (script == NULL) {
+                continue;
+            } else if (line.startsWith("filter#")) {
+                this->addFilter(script, line.mid(7).trimmed());
+            } else if (line.startsWith("filter_clear#")) {
+                scriptWriter->clearFilter(script->getId());
+            } else if (line.startsWith("subscribe#")) {
+                this->subscribe(script, line.mid(10).trimmed());
+            } else if (line.startsWith("unsubscribe#")) {
+                this->unsubscribe(script, line.mid(12).trimmed());
+            } else if (line.startsWith("priority#")) {
+                script->setPriority(line.mid(9).trimmed().toInt());
+            }
+        }
+    }
+}
+
+void ScriptService::scheduleCommands() {
+    if(dispatchPending) return;
+    dispatchPending = true;
+    QTimer::singleShot(0, this, SLOT(dispatchCommands()));
+}
+
+/* commands queued by all scripts since the last pass are sent round robin,
+ * one per script per round with higher priority scripts first in each round,
+ * so a script flooding commands can not starve the others */
+void ScriptService::dispatchCommands() {
+    dispatchPending = false;
+
+    QList<ScriptCommandQueue*> ordered;
+    foreach (Script* script, scripts) ordered << script;
+    foreach (JsScript* script, jsScripts) ordered << script;
+    std::stable_sort(ordered.begin(), ordered.end(), [](ScriptCommandQueue* a, ScriptCommandQueue* b) {
+        return a->getPriority() > b->getPriority();
+    });
+
+    bool sent = true;
+    while(sent) {
+        sent = false;
+        foreach (ScriptCommandQueue* script, ordered) {
+            if(script->hasCommands()) {
+                commandLine->writeCommand(script->takeCommand(), "script");
+                sent = true;
             }
         }
     }
 }
 
+/* patterns arrive as a json array of {"source": ..., "flags": ...} */
+void ScriptService::addFilter(Script* script, QByteArray patterns) {
+    foreach (QJsonValue value, QJsonDocument::fromJson(patterns).array()) {
+        QJsonObject pattern = value.toObject();
+        QString source = pattern.value("source").toString();
+        if(!scriptWriter->addFilter(script->getId(), source, pattern.value("flags").toString())) {
+            windowFacade->writeGameWindow("[Script text filter /" + source.toHtmlEscaped().toLocal8Bit() +
+                                          "/ is not supported, sending all game text.]");
+        }
+    }
+}
+
+void ScriptService::subscribe(Script* script, QByteArray fields) {
+    QSet<QString>* subscriptions = script->getSubscriptions();
+
+    QStringList added;
+    foreach (QByteArray field, fields.split(',')) {
+        QString name = QString(field.trimmed()).toUpper();
+        if(!name.isEmpty() && !subscriptions->contains(name)) {
+            subscriptions->insert(name);
+            added << name;
+        }
+    }
+    // current values first so the script starts from a known state;
+    // events such as EXP_PULSE have no value and are skipped
+    QVariantMap values = data->snapshot(added);
+    foreach (QString name, values.keys()) {
+        if(!values.value(name).isValid()) values.remove(name);
+    }
+    if(!values.isEmpty()) this->pushState(script, values);
+}
+
+void ScriptService::unsubscribe(Script* script, QByteArray fields) {
+    QSet<QString>* subscriptions = script->getSubscriptions();
+    if(fields.isEmpty()) {
+        subscriptions->clear();
+        return;
+    }
+    foreach (QByteArray field, fields.split(',')) {
+        subscriptions->remove(QString(field.trimmed()).toUpper());
+    }
+}
+
+void ScriptService::stateChanged(QString field, QVariant value) {
+    foreach (Script* script, scripts) {
+        if(script->getSubscriptions()->contains(field) && script->isRunning()) {
+            QVariantMap values;
+            values.insert(field, value);
+            this->pushState(script, values);
+        }
+    }
+}
+
+void ScriptService::pushState(Script* script, const QVariantMap& values) {
+    QJsonDocument doc(QJsonObject::fromVariantMap(values));
+    script->sendMessage("state#" + doc.toJson(QJsonDocument::Compact) + "\n");
+}
+
 ScriptService::~ScriptService() {
-    delete script;
+    // interrupt every javascript script first so they unwind together
+    foreach (JsScript* script, jsScripts) {
+        script->abort();
+    }
+    qDeleteAll(pool);
+    qDeleteAll(scripts);
+    qDeleteAll(jsScripts);
     delete scriptWriter;
 }
@@ -3,6 +3,9 @@
 
 #include <QObject>
 #include <QElapsedTimer>
+#include <QSet>
+#include <QVariant>
+#include <QFileSystemWatcher>
 
 class MainWindow;
 class CommandLine;
@@ -10,6 +13,9 @@ class Script;
 class TextUtils;
 class ScriptWriterThread;
 class WindowFacade;
+class GameDataContainer;
+class JsScript;
+class MapData;
 
 class ScriptService : public QObject {
     Q_OBJECT
@@ -19,12 +25,15 @@ public:
     ~ScriptService();
 
     void writeGameWindow(QByteArray);    
-    void processCommand(QByteArray);
+    void processCommand(QByteArray, Script* script = NULL);
     void runScript(QString);
     void terminateScript();
     void abortScript();
-    void scriptFinished();
-    void scriptEnded();
+    void abortScript(QString);
+    void listScripts();
+    void scriptFinished(Script*);
+    void scriptEnded(Script*);
+    void jsScriptEnded(JsScript*);
     bool isScriptActive();
 
 private:
@@ -32,17 +41,47 @@ private:
     MainWindow* mainWindow;
     CommandLine* commandLine;
     WindowFacade* windowFacade;
-    Script* script;
-    QElapsedTimer timer;
-    bool terminateFlag;
+    GameDataContainer* data;
+    MapData* mapData;
+    QList<Script*> scripts;
+    QList<JsScript*> jsScripts;
+    QList<Script*> pool;
+    int nextScriptId;
+    bool dispatchPending;
+
+    QFileSystemWatcher scriptWatcher;
+    QSet<QString> scriptIndex;
+    QString indexedPath;
+
+    bool scriptExists(QString fileName);
+    QString scriptType(QString fileName);
+    void startScript(QString fileName, QList<QString> args);
+    void startJsScript(QString fileName, QList<QString> args);
+
+    Script* findScript(QString fileName);
+    Script* findScript(int id);
+    JsScript* findJsScript(QString fileName);
+    void abortScript(Script*);
+    void abortScript(JsScript*);
+    void terminateScript(Script*);
+    void scheduleCommands();
+    void addFilter(Script* script, QByteArray patterns);
+    void subscribe(Script* script, QByteArray fields);
+    void unsubscribe(Script* script, QByteArray fields);
+    void pushState(Script* script, const QVariantMap& values);
 
 public slots:
-    void writeScriptText(QByteArray);
-    void writeOutgoingMessage(QByteArray);
+    void writeScriptText(QByteArray, bool prompt = false);
+    void writeOutgoingMessage(QByteArray, QList<int>);
+    void writeMatchMessage(int, QByteArray);
+    void stateChanged(QString field, QVariant value);
+
+private slots:
+    void dispatchCommands();
+    void indexScripts();
+    void fillPool();
 
 signals:
-    void sendMessage(QByteArray message);
-    void killScript();
 
 };
 
@@ -1,83 +1,362 @@
 #include "scriptstreamserver.h"
 
+#include <QDir>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+
 #include "log4qt/logger.h"
 
 #include "clientsettings.h"
+#include "apisettings.h"
 #include "defaultvalues.h"
+#include "streamclient.h"
+#include "gamedatacontainer.h"
+#include "textutils.h"
 
 ScriptStreamServer::ScriptStreamServer(QObject* parent) : Parent(parent) {
+    apiSettings = new ApiSettings();
+    rxTags.setPattern("<[^>]*>");
+    queueLimit = SCRIPT_STREAM_QUEUE_LIMIT;
+    overflow = DropOldest;
+    fullClients = 0;
+
+    // plain lines, the stream carries no script channel prefix
+    textPrefix.clear();
+
     start();
     connect(&server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
-    connect(this, SIGNAL(writeText(QByteArray)), this, SLOT(sendMessage(QByteArray)));
+    connect(&localServer, SIGNAL(newConnection()), this, SLOT(onNewLocalConnection()));
+    connect(this, SIGNAL(writeText(QByteArray, QList<int>)), this, SLOT(sendMessage(QByteArray)));
+    connect(this, SIGNAL(stalled()), this, SLOT(disconnectStalled()));
 
     restart();
 }
 
 ScriptStreamServer::~ScriptStreamServer() {
     close();
+    delete apiSettings;
 }
 
 void ScriptStreamServer::writeData(QString message) {
     // only add to the queue if we have sockets connected
     // and server is listening, no need to waste resources
-    if (server.isListening() && sockets.size()) {
+    if (isListening() && clients.size()) {
         Parent::addData(message);
     }
 }
 
+/* runs on the writer thread; waiting here keeps lines in the input
+ * queue instead of dropping them while a blocking client catches up */
+void ScriptStreamServer::onProcess(const QString& data) {
+    QMutexLocker locker(&blockMutex);
+    if(fullClients > 0 && !roomAvailable.wait(&blockMutex, SCRIPT_STREAM_BLOCK_TIMEOUT)) {
+        emit stalled();
+    }
+    locker.unlock();
+
+    Parent::onProcess(data);
+}
+
+bool ScriptStreamServer::isListening() {
+    return server.isListening() || localServer.isListening();
+}
+
 void ScriptStreamServer::onNewConnection() {
-    QTcpSocket* clientSocket = server.nextPendingConnection();
-    connect(clientSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), this,
-            SLOT(onSocketStateChanged(QAbstractSocket::SocketState)));
+    QTcpSocket* socket = server.nextPendingConnection();
+    addSocket(socket, "tcp:" + QString::number(socket->peerPort()));
+}
 
-    sockets.push_back(clientSocket);
+void ScriptStreamServer::onNewLocalConnection() {
+    addSocket(localServer.nextPendingConnection(), "local:" + QString::number(clients.size() + 1));
 }
 
-void ScriptStreamServer::onSocketStateChanged(QAbstractSocket::SocketState socketState) {
-    if (socketState == QAbstractSocket::UnconnectedState) {
-        QTcpSocket* sender = static_cast<QTcpSocket*>(QObject::sender());
-        sockets.removeOne(sender);
+void ScriptStreamServer::addSocket(QIODevice* socket, QString name) {
+    connect(socket, SIGNAL(disconnected()), this, SLOT(onSocketDisconnected()));
+    connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten()));
+    connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+
+    clients.insert(socket, new StreamClient(socket, name));
+}
+
+void ScriptStreamServer::onSocketDisconnected() {
+    QIODevice* sender = static_cast<QIODevice*>(QObject::sender());
+    StreamClient* client = clients.take(sender);
+    if(client != NULL) {
+        setFull(client, false);
+        delete client;
+    }
+}
+
+void ScriptStreamServer::onBytesWritten() {
+    StreamClient* client = clients.value(static_cast<QIODevice*>(QObject::sender()));
+    if(client == NULL) return;
+
+    client->flush();
+    if(client->isFull() && client->queuedBytes() <= queueLimit) {
+        setFull(client, false);
     }
 }
 
+void ScriptStreamServer::setFull(StreamClient* client, bool full) {
+    if(client->isFull() == full) return;
+    client->setFull(full);
+
+    QMutexLocker locker(&blockMutex);
+    fullClients += full ? 1 : -1;
+    if(fullClients == 0) roomAvailable.wakeAll();
+}
+
+/* a blocking client that did not drain within the timeout is cut off */
+void ScriptStreamServer::disconnectStalled() {
+    foreach (StreamClient* client, clients.values()) {
+        if(client->isFull()) {
+            Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))
+                    ->info("Disconnecting stalled stream client " + client->getName());
+            abortSocket(client->getSocket());
+        }
+    }
+}
+
+/* close() would wait for the pending data of a client that does not read */
+void ScriptStreamServer::abortSocket(QIODevice* socket) {
+    if(QTcpSocket* tcpSocket = qobject_cast<QTcpSocket*>(socket)) {
+        tcpSocket->abort();
+    } else if(QLocalSocket* localSocket = qobject_cast<QLocalSocket*>(socket)) {
+        localSocket->abort();
+    }
+}
+
+QStringList ScriptStreamServer::clientStats() {
+    QStringList stats;
+    foreach (StreamClient* client, clients.values()) {
+        stats << client->getName() +
+                 ": lag " + QString::number(client->lag()) + " ms" +
+                 ", queued " + QString::number(client->queuedBytes() + client->getSocket()->bytesToWrite()) +
+                 " bytes, written " + QString::number(client->writtenBytes()) +
+                 " bytes, dropped " + QString::number(client->droppedBytes()) + " bytes";
+    }
+    return stats;
+}
+
 void ScriptStreamServer::reloadSettings() {
     restart();
 }
 
+/* message is a batch of newline terminated lines, shared by all text clients */
 void ScriptStreamServer::sendMessage(QByteArray message) {
-    for (QTcpSocket* socket : sockets) {
-        socket->write(message.append('\n'));
+    foreach (StreamClient* client, clients.values()) {
+        if(!client->isEventMode()) deliver(client, message);
+    }
+}
+
+void ScriptStreamServer::deliver(StreamClient* client, const QByteArray& data) {
+    client->enqueue(data);
+    if(client->queuedBytes() > queueLimit) {
+        if(overflow == DropOldest) {
+            client->dropOldest(queueLimit);
+        } else if(overflow == Disconnect) {
+            Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))
+                    ->info("Disconnecting slow stream client " + client->getName());
+            abortSocket(client->getSocket());
+            return;
+        } else {
+            setFull(client, true);
+        }
+    }
+    client->flush();
+}
+
+/* clients send "EVENTS [type,...]" to receive json events, "TEXT" to go back to plain text */
+void ScriptStreamServer::onReadyRead() {
+    StreamClient* client = clients.value(static_cast<QIODevice*>(QObject::sender()));
+    if(client == NULL) return;
+
+    while(client->getSocket()->canReadLine()) {
+        QString line = QString::fromUtf8(client->getSocket()->readLine()).trimmed();
+        if(line.startsWith("EVENTS", Qt::CaseInsensitive)) {
+            QSet<QString> types;
+            foreach (QString type, line.mid(6).split(',', QString::SkipEmptyParts)) {
+                types.insert(type.trimmed().toLower());
+            }
+            client->setEventMode(true, types);
+        } else if(line.compare("TEXT", Qt::CaseInsensitive) == 0) {
+            client->setEventMode(false, QSet<QString>());
+        }
+    }
+}
+
+bool ScriptStreamServer::wantsEvent(const QString& type) {
+    foreach (StreamClient* client, clients) {
+        if(client->wants(type)) return true;
+    }
+    return false;
+}
+
+/* one json object per line; built once and shared by the clients that asked for the type */
+void ScriptStreamServer::writeEvent(QString type, QVariantMap fields) {
+    if(!wantsEvent(type)) return;
+
+    fields.insert("type", type);
+    fields.insert("ts", QDateTime::currentMSecsSinceEpoch());
+    QByteArray line = QJsonDocument(QJsonObject::fromVariantMap(fields)).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    foreach (StreamClient* client, clients.values()) {
+        if(client->wants(type)) deliver(client, line);
+    }
+}
+
+QString ScriptStreamServer::toPlain(QString html) {
+    html.remove(rxTags);
+    TextUtils::htmlToPlain(html);
+    return html;
+}
+
+void ScriptStreamServer::writeTextEvent(QByteArray text, bool prompt) {
+    if(!wantsEvent("text") || text.isEmpty()) return;
+
+    QVariantMap fields;
+    fields.insert("stream", "main");
+    fields.insert("prompt", prompt);
+    fields.insert("text", toPlain(QString::fromLocal8Bit(text)));
+    // markup keeps the style classes (bold, echo, speech...)
+    fields.insert("html", QString::fromLocal8Bit(text));
+    writeEvent("text", fields);
+}
+
+void ScriptStreamServer::writeStreamEvent(QString stream, QString text) {
+    if(!wantsEvent("text")) return;
+
+    QVariantMap fields;
+    fields.insert("stream", stream);
+    fields.insert("text", toPlain(text));
+    fields.insert("html", text);
+    writeEvent("text", fields);
+}
+
+void ScriptStreamServer::writePromptEvent(QString prompt, int serverTime) {
+    QVariantMap fields;
+    fields.insert("prompt", prompt);
+    fields.insert("serverTime", serverTime);
+    writeEvent("prompt", fields);
+}
+
+void ScriptStreamServer::writeExpEvent(QString skill, QString text) {
+    QVariantMap fields;
+    fields.insert("skill", skill);
+    fields.insert("text", toPlain(text).trimmed());
+    writeEvent("exp", fields);
+}
+
+void ScriptStreamServer::writeRoomEvent() {
+    if(!wantsEvent("room")) return;
+
+    GameDataContainer* data = GameDataContainer::Instance();
+    QVariantMap fields;
+    fields.insert("id", data->getRoomId());
+    fields.insert("title", data->getRoomName());
+    fields.insert("description", toPlain(data->getRoomDesc()));
+    fields.insert("objects", toPlain(data->getRoomObjs()));
+    fields.insert("players", toPlain(data->getRoomPlayers()));
+    fields.insert("exits", toPlain(data->getRoomExits()));
+    writeEvent("room", fields);
+}
+
+/* game data changes pushed by GameDataContainer */
+void ScriptStreamServer::writeStateEvent(QString field, QVariant value) {
+    static const QHash<QString, QString> types {
+        {"HEALTH", "vitals"}, {"CONCENTRATION", "vitals"}, {"SPIRIT", "vitals"},
+        {"FATIGUE", "vitals"}, {"MANA", "vitals"},
+        {"STANDING", "indicator"}, {"SITTING", "indicator"}, {"KNEELING", "indicator"},
+        {"PRONE", "indicator"}, {"STUNNED", "indicator"}, {"BLEEDING", "indicator"},
+        {"HIDDEN", "indicator"}, {"INVISIBLE", "indicator"}, {"WEBBED", "indicator"},
+        {"JOINED", "indicator"}, {"DEAD", "indicator"},
+        {"RT", "roundtime"}, {"CT", "roundtime"},
+        {"ACTIVE_SPELLS", "spells"}
+    };
+
+    QVariantMap fields;
+    if(field == "EXP_PULSE") {
+        fields.insert("skill", value);
+        fields.insert("pulse", true);
+        writeEvent("exp", fields);
+    } else if(types.contains(field)) {
+        fields.insert("name", field.toLower());
+        fields.insert("value", value);
+        writeEvent(types.value(field), fields);
     }
 }
 
 void ScriptStreamServer::close() {
-    for (QTcpSocket* socket : sockets) {
-        socket->close();
+    foreach (StreamClient* client, clients.values()) {
+        client->getSocket()->close();
     }
-    sockets.clear();
+    qDeleteAll(clients);
+    clients.clear();
+
+    QMutexLocker locker(&blockMutex);
+    fullClients = 0;
+    roomAvailable.wakeAll();
+    locker.unlock();
+
     if (server.isListening()) {
         server.close();
     }
+    if (localServer.isListening()) {
+        localServer.close();
+    }
 }
 
 void ScriptStreamServer::restart() {
     bool enabled = ClientSettings::getInstance()
                            ->getParameter("Script/streamingServerEnabled", SCRIPT_STREAMING_ENABLED)
                            .toBool();
+    bool localEnabled = ClientSettings::getInstance()
+                           ->getParameter("Script/localSocketEnabled", SCRIPT_LOCAL_SOCKET_ENABLED)
+                           .toBool();
     int port = ClientSettings::getInstance()->getParameter("Script/streamingServerPort", 0).toInt();
 
+    queueLimit = ClientSettings::getInstance()
+            ->getParameter("Script/streamQueueLimit", SCRIPT_STREAM_QUEUE_LIMIT).toLongLong();
+    QString policy = ClientSettings::getInstance()
+            ->getParameter("Script/streamOverflow", SCRIPT_STREAM_OVERFLOW).toString();
+    overflow = policy == "disconnect" ? Disconnect : policy == "block" ? Block : DropOldest;
+
     // check if need to close the server
-    if (enabled && server.isListening() && port == server.serverPort()) {
+    if (enabled && server.isListening() && port == server.serverPort() &&
+            localEnabled == localServer.isListening()) {
         // no changes needed
         return;
     }
 
     close();
+    apiSettings->setParameter("StreamServer/port", "");
+    apiSettings->setParameter("StreamServer/socket", "");
     // start server if necessary
     if (enabled) {
-        if (!server.listen(QHostAddress::Any, port)) {
+        // scripts run on this machine; the stream is not exposed on the network
+        if (!server.listen(QHostAddress::LocalHost, port)) {
             Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))
                     ->info("Unable to start Streaming server" + server.errorString());
+        } else {
+            apiSettings->setParameter("StreamServer/port", server.serverPort());
         }
+        restartLocal(localEnabled);
+    }
+}
+
+void ScriptStreamServer::restartLocal(bool enabled) {
+    if (!enabled) return;
+
+    QString name = SCRIPT_LOCAL_SOCKET("stream");
+    QLocalServer::removeServer(name);
+    localServer.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!localServer.listen(name)) {
+        Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))
+                ->info("Unable to start local Streaming server" + localServer.errorString());
+        return;
     }
+    apiSettings->setParameter("StreamServer/socket", localServer.fullServerName());
 }
@@ -4,34 +4,83 @@
 #include "qobjectdefs.h"
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QLocalServer>
+#include <QLocalSocket>
 #include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVariantMap>
+#include <QRegExp>
 
 #include "scriptwriterthread.h"
 
+class ApiSettings;
+class StreamClient;
+
 class ScriptStreamServer : public ScriptWriterThread {
     Q_OBJECT
 public:
     using Parent = ScriptWriterThread;
 
+    enum Overflow { DropOldest, Disconnect, Block };
+
 public:
     explicit ScriptStreamServer(QObject* parent = 0);
     virtual ~ScriptStreamServer();
 
+    void onProcess(const QString& data) override;
+    QStringList clientStats();
+
 private:
     void restart();
+    void restartLocal(bool enabled);
     void close();
+    bool isListening();
+    void addSocket(QIODevice* socket, QString name);
+    void setFull(StreamClient* client, bool full);
+    void abortSocket(QIODevice* socket);
+    void deliver(StreamClient* client, const QByteArray& data);
+    bool wantsEvent(const QString& type);
+    void writeEvent(QString type, QVariantMap fields);
+    QString toPlain(QString html);
 
     QTcpServer server;
-    QList<QTcpSocket*> sockets;
+    QLocalServer localServer;
+    QHash<QIODevice*, StreamClient*> clients;
+    ApiSettings* apiSettings;
+
+    QRegExp rxTags;
+    qint64 queueLimit;
+    Overflow overflow;
+
+    // clients under the block policy with a full queue hold back the writer thread
+    int fullClients;
+    QMutex blockMutex;
+    QWaitCondition roomAvailable;
+
+signals:
+    void stalled();
 
 public slots:
     void reloadSettings();
     // Put the message to the queue for processing and sending
     void writeData(QString message);
+    // typed events for clients in event mode
+    void writeTextEvent(QByteArray text, bool prompt);
+    void writeStreamEvent(QString stream, QString text);
+    void writePromptEvent(QString prompt, int serverTime);
+    void writeExpEvent(QString skill, QString text);
+    void writeRoomEvent();
+    void writeStateEvent(QString field, QVariant value);
 private slots:
     // connection management
     void onNewConnection();
-    void onSocketStateChanged(QAbstractSocket::SocketState socketState);
+    void onNewLocalConnection();
+    void onSocketDisconnected();
+    void onBytesWritten();
+    void onReadyRead();
+    void disconnectStalled();
     // send data to open sockets
     void sendMessage(QByteArray message);
 };
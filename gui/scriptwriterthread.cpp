@@ -2,17 +2,81 @@
 #include "scriptservice.h"
 #include "textutils.h"
 
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
 ScriptWriterThread::ScriptWriterThread(QObject *parent) {
     scriptService = (ScriptService*)parent;
 
     rxRemoveTags.setPattern("<[^>]*>");
+    textPrefix = "game_text#";
 }
 
+/* tags are stripped once and the resulting text is shared by all running scripts */
 void ScriptWriterThread::onProcess(const QString& lines) {
+    QByteArray text;
+    QHash<int, QByteArray> matches;
+
+    QMutexLocker locker(&filterMutex);
+    QList<int> filtered;
+    foreach (int script, filters.keys()) {
+        if(!disabledFilters.contains(script)) filtered << script;
+    }
+
     foreach (QString line, lines.split("\n")) {
         line = line.remove(rxRemoveTags);
         TextUtils::htmlToPlain(line);
-        emit writeText(line.toLocal8Bit());
+        text.append(textPrefix).append(line.toLocal8Bit()).append('\n');
+
+        // scripts with a filter registered only get the matching lines
+        foreach (int script, filtered) {
+            foreach (const QRegularExpression& rx, filters.value(script)) {
+                QRegularExpressionMatch match = rx.match(line);
+                if(match.hasMatch()) {
+                    matches[script].append("match#").append(this->matchMessage(line, match)).append('\n');
+                    break;
+                }
+            }
+        }
+    }
+    locker.unlock();
+
+    emit writeText(text, filtered);
+    for (QHash<int, QByteArray>::const_iterator i = matches.constBegin(); i != matches.constEnd(); ++i) {
+        emit writeMatch(i.key(), i.value());
     }
 }
 
+QByteArray ScriptWriterThread::matchMessage(const QString& line, const QRegularExpressionMatch& match) {
+    QJsonObject obj;
+    obj.insert("line", line);
+    obj.insert("captures", QJsonArray::fromStringList(match.capturedTexts().mid(1)));
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+/* flags follow ruby regexp options: i - ignore case, m - dot matches newline, x - extended */
+bool ScriptWriterThread::addFilter(int script, const QString& source, const QString& flags) {
+    QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
+    if(flags.contains('i')) options |= QRegularExpression::CaseInsensitiveOption;
+    if(flags.contains('m')) options |= QRegularExpression::DotMatchesEverythingOption;
+    if(flags.contains('x')) options |= QRegularExpression::ExtendedPatternSyntaxOption;
+
+    QRegularExpression rx(source, options);
+    QMutexLocker locker(&filterMutex);
+    if(!rx.isValid()) {
+        // a pattern the client can not compile would silently drop
+        // lines the script waits for, so fall back to sending everything
+        disabledFilters.insert(script);
+        return false;
+    }
+    rx.optimize();
+    filters[script] << rx;
+    return true;
+}
+
+void ScriptWriterThread::clearFilter(int script) {
+    QMutexLocker locker(&filterMutex);
+    filters.remove(script);
+    disabledFilters.remove(script);
+}
@@ -2,8 +2,12 @@
 #define SCRIPTWRITERTHREAD_H
 
 #include <QRegExp>
+#include <QRegularExpression>
 #include <QString>
 #include <QByteArray>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
 
 #include "workqueuethread.h"
 
@@ -18,12 +22,27 @@ public:
 
     void onProcess(const QString& data) override;
 
+    bool addFilter(int script, const QString& source, const QString& flags);
+    void clearFilter(int script);
+
+protected:
+    /* written in front of every line of text */
+    QByteArray textPrefix;
+
 private:
     ScriptService* scriptService;
     QRegExp rxRemoveTags;
+
+    QHash<int, QList<QRegularExpression> > filters;
+    QSet<int> disabledFilters;
+    QMutex filterMutex;
+
+    QByteArray matchMessage(const QString& line, const QRegularExpressionMatch& match);
     
 signals:
-    void writeText(QByteArray);    
+    /* game text for every script, except the ones in filtered */
+    void writeText(QByteArray text, QList<int> filtered);
+    void writeMatch(int script, QByteArray text);
 };
 
 #endif // SCRIPTWRITERTHREAD_H
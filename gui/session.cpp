@@ -24,6 +24,8 @@
 #include "window/groupwindow.h"
 #include "window/combatwindow.h"
 #include "scriptservice.h"
+#include "scriptstreamserver.h"
+#include "trigger/triggerengine.h"
 
 Session::Session(MainWindow* parent, bool debug)
     : QObject(parent), mainWindow(static_cast<MainWindow*>(parent)) {
@@ -38,6 +40,8 @@ Session::Session(MainWindow* parent, bool debug)
     bindWindowFacade();
     bindWindows();
     bindScriptService();
+    bindStreamServer();
+    bindTriggerEngine();
     bindMainWindow();
 
     if (!xmlParser->isRunning()) {
@@ -154,6 +158,48 @@ void Session::bindScriptService() {
             SLOT(writeScriptText(QByteArray)));
 }
 
+void Session::bindStreamServer() {
+    // Connect events from xmlparser to the event stream of the streaming server
+    ScriptStreamServer* streamServer = mainWindow->getScriptStreamServer();
+    connect(xmlParser, SIGNAL(writeText(QByteArray, bool)), streamServer,
+            SLOT(writeTextEvent(QByteArray, bool)));
+    connect(xmlParser, SIGNAL(writeStreamWindow(QString, QString)), streamServer,
+            SLOT(writeStreamEvent(QString, QString)));
+    connect(xmlParser, SIGNAL(updatePrompt(QString, int)), streamServer,
+            SLOT(writePromptEvent(QString, int)));
+    connect(xmlParser, SIGNAL(updateExpWindow(QString, QString)), streamServer,
+            SLOT(writeExpEvent(QString, QString)));
+    connect(xmlParser, SIGNAL(updateRoomWindow()), streamServer, SLOT(writeRoomEvent()));
+    connect(GameDataContainer::Instance(), SIGNAL(changed(QString, QVariant)), streamServer,
+            SLOT(writeStateEvent(QString, QVariant)));
+
+    // dedicated windows carry their stream id in the signal name
+    const QList<QPair<void (XmlParserThread::*)(QString), QString> > streams {
+        {&XmlParserThread::updateConversationsWindow, "conversations"},
+        {&XmlParserThread::updateDeathsWindow, "death"},
+        {&XmlParserThread::updateThoughtsWindow, "thoughts"},
+        {&XmlParserThread::updateArrivalsWindow, "logons"},
+        {&XmlParserThread::updateFamiliarWindow, "familiar"},
+        {&XmlParserThread::updateAtmosphericsWindow, "atmospherics"},
+        {&XmlParserThread::updateCombatWindow, "combat"}
+    };
+    for (auto& stream : streams) {
+        QString id = stream.second;
+        connect(xmlParser, stream.first, streamServer, [streamServer, id](QString text) {
+            streamServer->writeStreamEvent(id, text);
+        });
+    }
+}
+
+void Session::bindTriggerEngine() {
+    // Game text is queued to the trigger engine straight from the parser thread
+    TriggerEngine* triggerEngine = mainWindow->getTriggerEngine();
+    connect(xmlParser, SIGNAL(writeText(QByteArray, bool)), triggerEngine,
+            SLOT(addText(QByteArray, bool)), Qt::DirectConnection);
+    connect(GameDataContainer::Instance(), SIGNAL(changed(QString, QVariant)), triggerEngine,
+            SLOT(stateChanged(QString, QVariant)));
+}
+
 void Session::bindMainWindow() {
     // Connect events from xmlparser to MainWindow.
     connect(xmlParser, SIGNAL(setMainTitle(QString)), mainWindow, SLOT(setMainTitle(QString)));
@@ -40,6 +40,8 @@ private:
     void bindWindowFacade();
     void bindWindows();
     void bindScriptService();
+    void bindStreamServer();
+    void bindTriggerEngine();
     void bindMainWindow();
 
     Lich* lich;
@@ -1,5 +1,15 @@
 #include "shareddataservice.h"
 
+#include <QDir>
+#include <QCoreApplication>
+
+#include <atomic>
+#include <cstring>
+
+#include "log4qt/logger.h"
+
+#include "apisettings.h"
+
 SharedDataService* SharedDataService::m_pInstance = NULL;
 
 SharedDataService* SharedDataService::Instance() {
@@ -9,65 +19,104 @@ SharedDataService* SharedDataService::Instance() {
     return m_pInstance;
 }
 
-SharedDataService::SharedDataService(QObject *parent) : QObject(parent) {
-    this->loadDataLib();    
+SharedDataService::SharedDataService(QObject *parent) : QObject(parent), data(NULL) {
+    this->open();
 }
 
-bool SharedDataService::isLoaded() {
-    return loaded;
-}
+void SharedDataService::open() {
+    file.setFileName(QDir::tempPath() + "/frostbite-shared-" +
+                     QString::number(QCoreApplication::applicationPid()) + ".dat");
 
-void SharedDataService::loadDataLib() {
-    dataLib = new QLibrary();
-    dataLib->setFileName(QApplication::applicationDirPath() + "/shared");
-    loaded = dataLib->load();
+    if(!file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !file.resize(sizeof(SharedData))) {
+        Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))->
+                info("Unable to create shared data file " + file.errorString());
+        return;
+    }
 
-    addExpField = (AddExp)dataLib->resolve("setExpField");
-    removeExpField = (RemoveExp)dataLib->resolve("removeExpField");
+    uchar* memory = file.map(0, sizeof(SharedData));
+    if(memory == NULL) {
+        Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))->
+                info("Unable to map shared data file " + file.errorString());
+        file.close();
+        return;
+    }
 
-    setStanding = (Set_b)dataLib->resolve("setStanding");
-    setSitting = (Set_b)dataLib->resolve("setSitting");
-    setKneeling = (Set_b)dataLib->resolve("setKneeling");
-    setProne = (Set_b)dataLib->resolve("setProne");
-    setStunned = (Set_b)dataLib->resolve("setStunned");
-    setBleeding = (Set_b)dataLib->resolve("setBleeding");
-    setHidden = (Set_b)dataLib->resolve("setHidden");
-    setInvisible = (Set_b)dataLib->resolve("setInvisible");
-    setWebbed = (Set_b)dataLib->resolve("setWebbed");
-    setJoined = (Set_b)dataLib->resolve("setJoined");
-    setDead = (Set_b)dataLib->resolve("setDead");
+    data = reinterpret_cast<SharedData*>(memory);
+    memset(data, 0, sizeof(SharedData));
+    data->version = SHARED_DATA_VERSION;
+    data->size = sizeof(SharedData);
+    // magic last so readers never see a half initialized segment
+    std::atomic_thread_fence(std::memory_order_release);
+    data->magic = SHARED_DATA_MAGIC;
 
-    setActiveSpells = (Set_s)dataLib->resolve("setActiveSpells");
+    ApiSettings apiSettings;
+    apiSettings.setParameter("SharedData/path", QDir::toNativeSeparators(file.fileName()));
+}
 
-    setInventory = (Set_s)dataLib->resolve("setInventory");
+bool SharedDataService::isLoaded() {
+    return data != NULL;
+}
 
-    setContainer = (Set_s)dataLib->resolve("setContainer");
+/* seqlock write; sequence is odd while fields are being changed */
+void SharedDataService::update(std::function<void(SharedData*)> write) {
+    QMutexLocker locker(&writeMutex);
+    if(data == NULL) return;
 
-    setWieldRight = (Set_s)dataLib->resolve("setWieldRight");
-    setWieldRightNoun = (Set_s)dataLib->resolve("setWieldRightNoun");
-    setWieldLeft = (Set_s)dataLib->resolve("setWieldLeft");
-    setWieldLeftNoun = (Set_s)dataLib->resolve("setWieldLeftNoun");
+    std::atomic<uint32_t>* sequence = reinterpret_cast<std::atomic<uint32_t>*>(&data->sequence);
 
-    setHealth = (Set_i)dataLib->resolve("setHealth");
-    setConcentration = (Set_i)dataLib->resolve("setConcentration");
-    setSpirit = (Set_i)dataLib->resolve("setSpirit");
-    setFatigue = (Set_i)dataLib->resolve("setFatigue");
+    sequence->store(sequence->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    write(data);
+    sequence->store(sequence->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
 
-    setRoomTitle = (Set_s)dataLib->resolve("setRoomTitle");
-    setRoomDescription = (Set_s)dataLib->resolve("setRoomDescription");
-    setRoomObjects = (Set_s)dataLib->resolve("setRoomObjects");
-    setRoomPlayers = (Set_s)dataLib->resolve("setRoomPlayers");
-    setRoomExits = (Set_s)dataLib->resolve("setRoomExits");
+void SharedDataService::setInt(SharedDataInt field, int value) {
+    this->update([field, value](SharedData* shared) {
+        shared->ints[field] = value;
+    });
+}
 
-    setRt = (Set_i)dataLib->resolve("setRt");
+void SharedDataService::setFlag(SharedDataFlag flag, bool value) {
+    this->update([flag, value](SharedData* shared) {
+        if(value) {
+            shared->flags |= (1u << flag);
+        } else {
+            shared->flags &= ~(1u << flag);
+        }
+    });
+}
 
-    setBleeding(true);
+void SharedDataService::setString(SharedDataString field, const QString& value) {
+    QByteArray utf8 = value.toUtf8();
+    bool truncated = utf8.size() > SHARED_DATA_STRING_SIZE - 1;
+    if(truncated) {
+        // never leave half of a multi-byte character behind
+        int size = SHARED_DATA_STRING_SIZE - 1;
+        while(size > 0 && (utf8.at(size) & 0xC0) == 0x80) size--;
+        utf8.truncate(size);
+    }
+    this->update([field, utf8, truncated](SharedData* shared) {
+        memcpy(shared->strings[field], utf8.constData(), utf8.size());
+        memset(shared->strings[field] + utf8.size(), 0, SHARED_DATA_STRING_SIZE - utf8.size());
+        if(truncated) {
+            shared->truncated |= (1u << field);
+        } else {
+            shared->truncated &= ~(1u << field);
+        }
+    });
+}
 
-    //destroy = (Destroy)dataLib->resolve("destroy");
+/* unmaps and removes the file; later writes are dropped */
+void SharedDataService::close() {
+    QMutexLocker locker(&writeMutex);
+    if(data != NULL) {
+        file.unmap(reinterpret_cast<uchar*>(data));
+        data = NULL;
+    }
+    file.close();
+    file.remove();
 }
 
-/*SharedDataService::~SharedDataService() {
-    destroy();
-    dataLib->unload();
-    delete dataLib;
-}*/
+SharedDataService::~SharedDataService() {
+    this->close();
+}
@@ -2,64 +2,32 @@
 #define SHAREDDATASERVICE_H
 
 #include <QObject>
-#include <QLibrary>
-#include <QDebug>
-#include <QDir>
-#include <QApplication>
+#include <QFile>
+#include <QMutex>
 
+#include <functional>
+
+#include "shared/shareddata.h"
+
+class ApiSettings;
+
+/*
+ * Publishes game state into a memory mapped file for scripts
+ * (see shared/shareddata.h for the layout and reader protocol).
+ */
 class SharedDataService : public QObject {
     Q_OBJECT
 
 public:
     static SharedDataService* Instance();
-    //~SharedDataService();
-
-    //typedef void (*AddExp)(const char*, const char*, const char*);
-    typedef void (*AddExp)(const char*, int, int);
-    typedef void (*RemoveExp)(const char*);
-    typedef void (*Set_b)(bool);
-    typedef void (*Set_s)(const char*);
-    typedef void (*Set_i)(int);
+    ~SharedDataService();
 
     bool isLoaded();
+    void close();
 
-    AddExp addExpField;
-    RemoveExp removeExpField;
-
-    Set_b setStanding;
-    Set_b setSitting;
-    Set_b setKneeling;
-    Set_b setProne;
-    Set_b setStunned;
-    Set_b setBleeding;
-    Set_b setHidden;
-    Set_b setInvisible;
-    Set_b setWebbed;
-    Set_b setJoined;
-    Set_b setDead;
-
-    Set_s setActiveSpells;
-
-    Set_s setInventory;
-    Set_s setContainer;
-    Set_s setWieldRight;
-    Set_s setWieldRightNoun;
-    Set_s setWieldLeft;
-    Set_s setWieldLeftNoun;
-
-    Set_i setHealth;
-    Set_i setConcentration;
-    Set_i setSpirit;
-    Set_i setFatigue;
-
-    Set_s setRoomTitle;
-    Set_s setRoomDescription;
-    Set_s setRoomObjects;
-    Set_s setRoomPlayers;
-    Set_s setRoomExits;
-
-    Set_i setRt;
-
+    void setInt(SharedDataInt field, int value);
+    void setFlag(SharedDataFlag flag, bool value);
+    void setString(SharedDataString field, const QString& value);
 
 private:
     SharedDataService(QObject *parent = 0);
@@ -67,10 +35,12 @@ private:
     SharedDataService& operator = (SharedDataService const& copy);
     static SharedDataService* m_pInstance;
 
-    void loadDataLib();
+    void open();
+    void update(std::function<void(SharedData*)> write);
 
-    QLibrary* dataLib;
-    bool loaded;
+    QFile file;
+    SharedData* data;
+    QMutex writeMutex;
 
 signals:
 
@@ -0,0 +1,89 @@
+#include "streamclient.h"
+
+#include "defaultvalues.h"
+
+StreamClient::StreamClient(QIODevice* socket, QString name) {
+    this->socket = socket;
+    this->name = name;
+
+    queued = 0;
+    dropped = 0;
+    written = 0;
+    full = false;
+    events = false;
+    clock.start();
+}
+
+QIODevice* StreamClient::getSocket() const {
+    return socket;
+}
+
+QString StreamClient::getName() const {
+    return name;
+}
+
+void StreamClient::enqueue(const QByteArray& batch) {
+    queue.enqueue(qMakePair(clock.elapsed(), batch));
+    queued += batch.size();
+}
+
+void StreamClient::dropOldest(qint64 limit) {
+    while(queued > limit && !queue.isEmpty()) {
+        qint64 size = queue.dequeue().second.size();
+        queued -= size;
+        dropped += size;
+    }
+}
+
+/* queued batches are joined into one write, and only while
+ * the socket's own buffer is below a chunk; the rest waits
+ * here, where it is bounded, until bytesWritten */
+void StreamClient::flush() {
+    if(queue.isEmpty() || socket->bytesToWrite() >= SCRIPT_STREAM_WRITE_CHUNK) return;
+
+    QByteArray data;
+    while(!queue.isEmpty() && data.size() < SCRIPT_STREAM_WRITE_CHUNK) {
+        data.append(queue.dequeue().second);
+    }
+    queued -= data.size();
+    written += data.size();
+    socket->write(data);
+}
+
+qint64 StreamClient::queuedBytes() const {
+    return queued;
+}
+
+qint64 StreamClient::droppedBytes() const {
+    return dropped;
+}
+
+qint64 StreamClient::writtenBytes() const {
+    return written;
+}
+
+/* age of the oldest batch not yet handed to the socket, in ms */
+qint64 StreamClient::lag() const {
+    return queue.isEmpty() ? 0 : clock.elapsed() - queue.head().first;
+}
+
+bool StreamClient::isFull() const {
+    return full;
+}
+
+void StreamClient::setFull(bool full) {
+    this->full = full;
+}
+
+bool StreamClient::isEventMode() const {
+    return events;
+}
+
+void StreamClient::setEventMode(bool events, QSet<QString> types) {
+    this->events = events;
+    this->types = types;
+}
+
+bool StreamClient::wants(const QString& type) const {
+    return events && (types.isEmpty() || types.contains(type));
+}
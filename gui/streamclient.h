@@ -0,0 +1,51 @@
+#ifndef STREAMCLIENT_H
+#define STREAMCLIENT_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QQueue>
+#include <QPair>
+#include <QElapsedTimer>
+#include <QSet>
+
+/* one stream consumer: batches wait here until the socket has room */
+class StreamClient {
+public:
+    StreamClient(QIODevice* socket, QString name);
+
+    QIODevice* getSocket() const;
+    QString getName() const;
+
+    void enqueue(const QByteArray& batch);
+    void dropOldest(qint64 limit);
+    void flush();
+
+    qint64 queuedBytes() const;
+    qint64 droppedBytes() const;
+    qint64 writtenBytes() const;
+    qint64 lag() const;
+
+    bool isFull() const;
+    void setFull(bool full);
+
+    bool isEventMode() const;
+    void setEventMode(bool events, QSet<QString> types);
+    bool wants(const QString& type) const;
+
+private:
+    QIODevice* socket;
+    QString name;
+
+    QQueue<QPair<qint64, QByteArray> > queue;
+    QElapsedTimer clock;
+    qint64 queued;
+    qint64 dropped;
+    qint64 written;
+    bool full;
+
+    // event mode clients get json events instead of plain text, optionally only some types
+    bool events;
+    QSet<QString> types;
+};
+
+#endif // STREAMCLIENT_H
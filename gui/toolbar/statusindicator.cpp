@@ -4,19 +4,22 @@
 #include "defaultvalues.h"
 
 #include "gamedatacontainer.h"
+#include "uiupdatequeue.h"
+#include "pixmapatlas.h"
 
 StatusIndicator::StatusIndicator(QObject *parent) : QObject(parent) {
     gameDataContainer = GameDataContainer::Instance();
+    uiUpdateQueue = UiUpdateQueue::Instance();
+    pixmapAtlas = PixmapAtlas::Instance();
+    scale = 1;
 }
 
 QLabel *StatusIndicator::playerStatusLabel(const char* oName, const char* img, bool show) {
-    QImage statusImage(img);
-
     QLabel *statusLabel = new QLabel();
     statusLabel->setObjectName(oName);
 
     if(show) {
-        statusLabel->setPixmap(QPixmap::fromImage(statusImage));
+        this->setIcon(statusLabel, img);
     }
 
     statusLabel->setAlignment(Qt::AlignCenter);
@@ -37,7 +40,27 @@ QLabel *StatusIndicator::playerStatusLabel(const char* oName, const char* img, b
     return statusLabel;
 }
 
+QSize StatusIndicator::iconSize() {
+    // icons fill the label inside its 1px border
+    return QSize(T_STATUS_W * scale - 2, T_STATUS_H * scale - 2);
+}
+
+void StatusIndicator::setIcon(QLabel* label, QString icon) {
+    if(icon.isNull()) {
+        labelIcons.remove(label);
+        label->setPixmap(QPixmap());
+    } else {
+        labelIcons.insert(label, icon);
+        label->setPixmap(pixmapAtlas->pixmap(icon, iconSize()));
+    }
+}
+
 void StatusIndicator::setScale(float scale) {
+    this->scale = scale;
+    pixmapAtlas->preload(QStringList() << INVISIBLE_ICO << IMMOBILE_ICO << GROUP_ICO
+                         << HIDDEN_ICO << DEAD_ICO << STUNNED_ICO << BLEEDING_ICO
+                         << STANDING_ICO << KNEELING_ICO << SITTING_ICO << PRONE_ICO, iconSize());
+
     invisible->setFixedWidth(T_STATUS_W * scale);
     invisible->setFixedHeight(T_STATUS_H * scale);
 
@@ -55,6 +78,10 @@ void StatusIndicator::setScale(float scale) {
 
     posture->setFixedWidth(T_STATUS_W * scale);
     posture->setFixedHeight(T_STATUS_H * scale);
+
+    foreach(QLabel* label, labelIcons.keys()) {
+        this->setIcon(label, labelIcons.value(label));
+    }
 }
 
 QHash<QString, bool> StatusIndicator::getFullStatus() {
@@ -67,27 +94,21 @@ QWidget* StatusIndicator::create() {
     hLayout->setContentsMargins(20, 10, 20, 10);
 
     invisible = this->playerStatusLabel("invisible", INVISIBLE_ICO, false);
-    invisible->setScaledContents(true);
     hLayout->addWidget(invisible);
 
     immobile = this->playerStatusLabel("immobile", IMMOBILE_ICO, false);
-    immobile->setScaledContents(true);
     hLayout->addWidget(immobile);
 
     joined = this->playerStatusLabel("joined", GROUP_ICO, false);
-    joined->setScaledContents(true);
     hLayout->addWidget(joined);
 
     hidden = this->playerStatusLabel("hidden", HIDDEN_ICO, false);
-    hidden->setScaledContents(true);
     hLayout->addWidget(hidden);
 
     condition = this->playerStatusLabel("condition", STUNNED_ICO, false);
-    condition->setScaledContents(true);
     hLayout->addWidget(condition);
 
     posture = this->playerStatusLabel("posture", STANDING_ICO, false);
-    posture->setScaledContents(true);
     hLayout->addWidget(posture);
 
     widget->setLayout(hLayout);
@@ -154,44 +175,51 @@ bool StatusIndicator::visibleToBool(QString visible) {
 }
 
 void StatusIndicator::setInvisible(bool visible) {
-    if(visible) {
-        invisible->setPixmap(QPixmap(INVISIBLE_ICO));
-        invisible->adjustSize();
-        invisible->setToolTip(tr("Invisible"));
-    } else {
-        invisible->setToolTip("");
-        invisible->setPixmap(QPixmap());
-    }
+    uiUpdateQueue->post(invisible, "status/invisible", [=]() {
+        if(visible) {
+            this->setIcon(invisible, INVISIBLE_ICO);
+            invisible->setToolTip(tr("Invisible"));
+        } else {
+            invisible->setToolTip("");
+            this->setIcon(invisible, QString());
+        }
+    });
 }
 
 void StatusIndicator::setImmobile(bool visible) {
-    if(visible) {
-        immobile->setPixmap(QPixmap(IMMOBILE_ICO));
-        immobile->setToolTip(tr("Immobile"));
-    } else {
-        immobile->setToolTip("");
-        immobile->setPixmap(QPixmap());
-    }
+    uiUpdateQueue->post(immobile, "status/immobile", [=]() {
+        if(visible) {
+            this->setIcon(immobile, IMMOBILE_ICO);
+            immobile->setToolTip(tr("Immobile"));
+        } else {
+            immobile->setToolTip("");
+            this->setIcon(immobile, QString());
+        }
+    });
 }
 
 void StatusIndicator::setJoined(bool visible) {
-    if(visible) {
-        joined->setPixmap(QPixmap(GROUP_ICO));
-        joined->setToolTip(tr("Grouped"));
-    } else {
-        joined->setToolTip("");
-        joined->setPixmap(QPixmap());
-    }
+    uiUpdateQueue->post(joined, "status/joined", [=]() {
+        if(visible) {
+            this->setIcon(joined, GROUP_ICO);
+            joined->setToolTip(tr("Grouped"));
+        } else {
+            joined->setToolTip("");
+            this->setIcon(joined, QString());
+        }
+    });
 }
 
 void StatusIndicator::setHidden(bool visible) {
-    if(visible) {
-        hidden->setPixmap(QPixmap(HIDDEN_ICO));
-        hidden->setToolTip(tr("Hidden"));
-    } else {
-        hidden->setToolTip("");
-        hidden->setPixmap(QPixmap());
-    }
+    uiUpdateQueue->post(hidden, "status/hidden", [=]() {
+        if(visible) {
+            this->setIcon(hidden, HIDDEN_ICO);
+            hidden->setToolTip(tr("Hidden"));
+        } else {
+            hidden->setToolTip("");
+            this->setIcon(hidden, QString());
+        }
+    });
 }
 
 void StatusIndicator::setCondition(bool visible, QString icon) {
@@ -209,13 +237,10 @@ void StatusIndicator::setCondition(bool visible, QString icon) {
 }
 
 void StatusIndicator::updateCondition(const char* title, QString icon) {
-    if(icon.isNull()) {
-        condition->setPixmap(QPixmap());
-    } else {
-        condition->setPixmap(QPixmap(icon));
-    }
-
-    condition->setToolTip(tr(title));
+    uiUpdateQueue->post(condition, "status/condition", [=]() {
+        this->setIcon(condition, icon);
+        condition->setToolTip(tr(title));
+    });
 }
 
 void StatusIndicator::setPosture(bool visible, QString icon) {
@@ -233,8 +258,10 @@ void StatusIndicator::setPosture(bool visible, QString icon) {
 }
 
 void StatusIndicator::updatePosture(const char* title, QString icon) {
-    posture->setToolTip(tr(title));
-    posture->setPixmap(QPixmap(icon));
+    uiUpdateQueue->post(posture, "status/posture", [=]() {
+        posture->setToolTip(tr(title));
+        this->setIcon(posture, icon);
+    });
 }
 
 StatusIndicator::~StatusIndicator() {
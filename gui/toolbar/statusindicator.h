@@ -10,6 +10,8 @@
 #define T_STATUS_H 32
 
 class GameDataContainer;
+class UiUpdateQueue;
+class PixmapAtlas;
 
 class StatusIndicator : public QObject {
     Q_OBJECT
@@ -26,6 +28,14 @@ public:
 
 private:
     GameDataContainer* gameDataContainer;
+    UiUpdateQueue* uiUpdateQueue;
+    PixmapAtlas* pixmapAtlas;
+
+    float scale;
+    QHash<QLabel*, QString> labelIcons;
+
+    QSize iconSize();
+    void setIcon(QLabel* label, QString icon);
 
     QLabel *playerStatusLabel(const char*, const char*, bool);    
     void updatePosture(const char*, QString);
@@ -16,11 +16,14 @@
 #include "commandline.h"
 #include "textutils.h"
 #include "text/highlight/highlighter.h"
+#include "uiupdatequeue.h"
+#include "pixmapatlas.h"
 
 Toolbar::Toolbar(QObject *parent) : QObject(parent) {
     mainWindow = (MainWindow*)parent;
     gameDataContainer = GameDataContainer::Instance();
     clientSettings = ClientSettings::getInstance();
+    uiUpdateQueue = UiUpdateQueue::Instance();
 
     vitalsIndicator = new VitalsIndicator(this);
     statusIndicator = new StatusIndicator(this);
@@ -129,6 +132,9 @@ void Toolbar::loadToolbar() {
 }
 
 void Toolbar::setScale(float scale) {
+    // drop icons rendered for the previous scale
+    PixmapAtlas::Instance()->invalidate(":/images/");
+
     wieldLeft->setScale(scale);
     clientSettings->setParameter("Toolbar/wieldLeftScale", QString::number(scale));
     wieldRight->setScale(scale);
@@ -171,35 +177,37 @@ void Toolbar::updateVitals(QString name, QString value) {
     int intValue = value.toInt();
     if(name == "health") {
         gameDataContainer->setHealth(intValue);
-        vitalsIndicator->healthBar->setValue(intValue);
-        vitalsIndicator->healthBar->setToolTip("Health: " + value + "%");
-        vitalsIndicator->healthBar->repaint();
+        this->renderVitals(vitalsIndicator->healthBar, name, intValue, "Health: " + value + "%");
     } else if(name == "concentration") {
         gameDataContainer->setConcentration(intValue);
-        vitalsIndicator->concentrationBar->setValue(intValue);
-        vitalsIndicator->concentrationBar->setToolTip("Concentration: " + value + "%");
-        vitalsIndicator->concentrationBar->repaint();
+        this->renderVitals(vitalsIndicator->concentrationBar, name, intValue, "Concentration: " + value + "%");
     } else if(name == "stamina") {
         gameDataContainer->setFatigue(intValue);
-        vitalsIndicator->fatigueBar->setValue(intValue);
-        vitalsIndicator->fatigueBar->setToolTip("Fatigue: " + value + "%");
-        vitalsIndicator->fatigueBar->repaint();
+        this->renderVitals(vitalsIndicator->fatigueBar, name, intValue, "Fatigue: " + value + "%");
     } else if(name == "spirit") {
         gameDataContainer->setSpirit(intValue);
-        vitalsIndicator->spiritBar->setValue(intValue);
-        vitalsIndicator->spiritBar->setToolTip("Spirit: " + value + "%");
-        vitalsIndicator->spiritBar->repaint();
+        this->renderVitals(vitalsIndicator->spiritBar, name, intValue, "Spirit: " + value + "%");
     } else if(name == "mana") {
         gameDataContainer->setMana(intValue);
-        vitalsIndicator->manaBar->setValue(intValue);
-        vitalsIndicator->manaBar->setToolTip("Mana: " + value + "%");
-        vitalsIndicator->manaBar->repaint();
+        this->renderVitals(vitalsIndicator->manaBar, name, intValue, "Mana: " + value + "%");
     }
     highlighter->alert(name, intValue);
 }
 
+void Toolbar::renderVitals(QProgressBar* bar, QString name, int value, QString toolTip) {
+    QString key = "toolbar/vitals/" + name;
+    if(!uiUpdateQueue->changed(key, value)) return;
+
+    uiUpdateQueue->post(bar, key, [=]() {
+        bar->setValue(value);
+        bar->setToolTip(toolTip);
+    });
+}
+
 void Toolbar::updateStatus(QString visible, QString icon) {
-    statusIndicator->updateStatus(visible, icon);
+    if(uiUpdateQueue->changed("toolbar/status/" + icon, visible)) {
+        statusIndicator->updateStatus(visible, icon);
+    }
     if (visible == "y") {
         highlighter->alert(icon);
     }
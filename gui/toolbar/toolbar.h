@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QAction>
 
+class QProgressBar;
 class MainWindow;
 class QuickButtonDisplay;
 class QuickButtonEditDialog;
@@ -17,6 +18,7 @@ class ActiveSpellIndicator;
 class SpellIndicator;
 class ClientSettings;
 class Highlighter;
+class UiUpdateQueue;
 
 class Toolbar : public QObject {
     Q_OBJECT
@@ -54,6 +56,7 @@ private:
     Highlighter* highlighter;
 
     ClientSettings* clientSettings;
+    UiUpdateQueue* uiUpdateQueue;
 
     QAction* wieldLeftAction;
     QAction* wieldRightAction;
@@ -67,6 +70,7 @@ private:
 
     void addFullScreenButton();
     void addMuteButton();
+    void renderVitals(QProgressBar* bar, QString name, int value, QString toolTip);
 
 public slots:
     void quickButtonAction();
@@ -0,0 +1,9 @@
+HEADERS += \
+    $$PWD/triggersettings.h \
+    $$PWD/triggersettingsentry.h \
+    $$PWD/triggerengine.h
+
+SOURCES += \
+    $$PWD/triggersettings.cpp \
+    $$PWD/triggersettingsentry.cpp \
+    $$PWD/triggerengine.cpp
@@ -0,0 +1,228 @@
+#include "triggerengine.h"
+
+#include "log4qt/logger.h"
+
+#include "mainwindow.h"
+#include "windowfacade.h"
+#include "commandline.h"
+#include "timerbar.h"
+#include "textutils.h"
+#include "audio/audioplayer.h"
+#include "trigger/triggersettings.h"
+
+TriggerEngine::TriggerEngine(QObject *parent) : WorkQueueThread<QString>(parent) {
+    mainWindow = (MainWindow*)parent;
+    audioPlayer = new AudioPlayer(mainWindow);
+
+    rxRemoveTags.setPattern("<[^>]*>");
+    clock.start();
+
+    connect(this, SIGNAL(fire(QString, QString)), this, SLOT(runAction(QString, QString)),
+            Qt::QueuedConnection);
+    connect(mainWindow, SIGNAL(volumeChanged(int)), audioPlayer, SLOT(setVolume(int)));
+    connect(mainWindow, SIGNAL(volumeMuted(bool)), audioPlayer, SLOT(setMuted(bool)));
+    connect(mainWindow, SIGNAL(profileChanged()), this, SLOT(reloadSettings()));
+
+    this->reloadSettings();
+    this->start();
+}
+
+void TriggerEngine::reloadSettings() {
+    QList<CompiledTrigger> text;
+    QList<CompiledTrigger> state;
+
+    foreach (const TriggerSettingsEntry& entry, TriggerSettings::getInstance()->getTriggers()) {
+        if(!entry.enabled || entry.pattern.isEmpty()) continue;
+
+        CompiledTrigger trigger;
+        trigger.entry = entry;
+        trigger.negate = false;
+        trigger.active = false;
+        trigger.lastFired = -entry.cooldown;
+
+        if(entry.event == "state") {
+            if(this->compileState(trigger)) {
+                state << trigger;
+                continue;
+            }
+        } else {
+            trigger.rx.setPattern(entry.pattern);
+            trigger.rx.optimize();
+            if(trigger.rx.isValid()) {
+                text << trigger;
+                continue;
+            }
+        }
+        Log4Qt::Logger::logger(QLatin1String("ErrorLogger"))
+                ->info("Skipping invalid trigger: " + trigger.entry.toString());
+    }
+
+    QMutexLocker locker(&textMutex);
+    textTriggers = text;
+    locker.unlock();
+
+    stateTriggers = state;
+}
+
+/* "FIELD op value", "FIELD" or "!FIELD" */
+bool TriggerEngine::compileState(CompiledTrigger& trigger) {
+    static QRegularExpression rxCondition(
+                "^\\s*(!?)([A-Za-z_]+)\\s*(?:(<=|>=|==|!=|!~|<|>|~)\\s*(.*\\S))?\\s*$");
+
+    QRegularExpressionMatch match = rxCondition.match(trigger.entry.pattern);
+    if(!match.hasMatch()) return false;
+
+    trigger.negate = !match.captured(1).isEmpty();
+    trigger.field = match.captured(2).toUpper();
+    trigger.op = match.captured(3);
+    trigger.operand = match.captured(4);
+    return true;
+}
+
+void TriggerEngine::addText(QByteArray text, bool prompt) {
+    if(prompt || text.isEmpty()) return;
+    this->addData(QString::fromLocal8Bit(text));
+}
+
+void TriggerEngine::onProcess(const QString& lines) {
+    QMutexLocker locker(&textMutex);
+    if(textTriggers.isEmpty()) return;
+
+    foreach (QString line, lines.split("\n")) {
+        line = line.remove(rxRemoveTags);
+        TextUtils::htmlToPlain(line);
+        if(line.isEmpty()) continue;
+
+        for (int i = 0; i < textTriggers.size(); i++) {
+            CompiledTrigger& trigger = textTriggers[i];
+            QRegularExpressionMatch match = trigger.rx.match(line);
+            if(match.hasMatch() && !this->coolingDown(trigger)) {
+                emit fire(trigger.entry.action, this->expandCaptures(trigger.entry.value, match));
+            }
+        }
+    }
+}
+
+/* state triggers fire once when their condition turns true */
+void TriggerEngine::stateChanged(QString field, QVariant value) {
+    for (int i = 0; i < stateTriggers.size(); i++) {
+        CompiledTrigger& trigger = stateTriggers[i];
+        if(trigger.field != field) continue;
+
+        bool active = this->evaluate(trigger, value);
+        if(active && !trigger.active && !this->coolingDown(trigger)) {
+            this->runAction(trigger.entry.action, trigger.entry.value);
+        }
+        trigger.active = active;
+    }
+}
+
+bool TriggerEngine::evaluate(const CompiledTrigger& trigger, const QVariant& value) {
+    bool result;
+    if(trigger.op.isEmpty()) {
+        result = value.type() == QVariant::StringList ?
+                    !value.toStringList().isEmpty() : value.toBool();
+    } else if(trigger.op == "~" || trigger.op == "!~") {
+        bool found = false;
+        foreach (const QString& item, value.toStringList()) {
+            if(item.contains(trigger.operand, Qt::CaseInsensitive)) {
+                found = true;
+                break;
+            }
+        }
+        result = trigger.op == "~" ? found : !found;
+    } else {
+        bool isNumber;
+        double operand = trigger.operand.toDouble(&isNumber);
+        if(isNumber && value.canConvert<double>()) {
+            double current = value.toDouble();
+            if(trigger.op == "<") result = current < operand;
+            else if(trigger.op == "<=") result = current <= operand;
+            else if(trigger.op == ">") result = current > operand;
+            else if(trigger.op == ">=") result = current >= operand;
+            else if(trigger.op == "==") result = current == operand;
+            else result = current != operand;
+        } else {
+            int compare = QString::compare(value.toString(), trigger.operand, Qt::CaseInsensitive);
+            if(trigger.op == "<") result = compare < 0;
+            else if(trigger.op == "<=") result = compare <= 0;
+            else if(trigger.op == ">") result = compare > 0;
+            else if(trigger.op == ">=") result = compare >= 0;
+            else if(trigger.op == "==") result = compare == 0;
+            else result = compare != 0;
+        }
+    }
+    return trigger.negate ? !result : result;
+}
+
+bool TriggerEngine::coolingDown(CompiledTrigger& trigger) {
+    qint64 now = clock.elapsed();
+    if(now - trigger.lastFired < trigger.entry.cooldown) return true;
+    trigger.lastFired = now;
+    return false;
+}
+
+/* \0 - \9 are replaced with the captured groups */
+QString TriggerEngine::expandCaptures(const QString& value, const QRegularExpressionMatch& match) {
+    if(!value.contains('\\')) return value;
+
+    QString result;
+    for (int i = 0; i < value.size(); i++) {
+        if(value.at(i) == '\\' && i + 1 < value.size() && value.at(i + 1).isDigit()) {
+            result.append(match.captured(value.at(++i).digitValue()));
+        } else {
+            result.append(value.at(i));
+        }
+    }
+    return result;
+}
+
+/* $name is replaced with the trigger variable of that name */
+QString TriggerEngine::expandVariables(const QString& value) {
+    static QRegularExpression rxVariable("\\$(\\w+)");
+    if(!value.contains('$')) return value;
+
+    QString result;
+    int last = 0;
+    QRegularExpressionMatchIterator i = rxVariable.globalMatch(value);
+    while(i.hasNext()) {
+        QRegularExpressionMatch match = i.next();
+        result.append(value.mid(last, match.capturedStart() - last));
+        result.append(variables.value(match.captured(1)));
+        last = match.capturedEnd();
+    }
+    result.append(value.mid(last));
+    return result;
+}
+
+QString TriggerEngine::getVariable(const QString& name) {
+    return variables.value(name);
+}
+
+void TriggerEngine::runAction(QString action, QString value) {
+    value = this->expandVariables(value);
+
+    if(action == "command") {
+        foreach (const QString& command, value.split(';', QString::SkipEmptyParts)) {
+            mainWindow->getCommandLine()->writeCommand(command.trimmed(), "script");
+        }
+    } else if(action == "echo") {
+        QString text = value;
+        TextUtils::plainToHtml(text);
+        mainWindow->getWindowFacade()->writeGameWindow("<span class=\"echo\">" + text.toLocal8Bit() + "</span>");
+    } else if(action == "variable") {
+        int split = value.indexOf('=');
+        if(split > 0) variables.insert(value.left(split).trimmed(), value.mid(split + 1).trimmed());
+    } else if(action == "timer") {
+        mainWindow->getTimerBar()->setTimer(value.toInt());
+    } else if(action == "sound") {
+        audioPlayer->play(value);
+    }
+}
+
+TriggerEngine::~TriggerEngine() {
+    // the worker uses the trigger lists, stop it before they go away
+    this->stop();
+    this->wait();
+    delete audioPlayer;
+}
@@ -0,0 +1,77 @@
+#ifndef TRIGGERENGINE_H
+#define TRIGGERENGINE_H
+
+#include <QRegExp>
+#include <QRegularExpression>
+#include <QString>
+#include <QByteArray>
+#include <QVariant>
+#include <QMutex>
+#include <QHash>
+#include <QElapsedTimer>
+
+#include "workqueuethread.h"
+#include "trigger/triggersettingsentry.h"
+
+class MainWindow;
+class AudioPlayer;
+
+struct CompiledTrigger {
+    TriggerSettingsEntry entry;
+    /* text triggers */
+    QRegularExpression rx;
+    /* state triggers, e.g. "HEALTH < 50" or "ACTIVE_SPELLS !~ Khri Prowess" */
+    QString field;
+    QString op;
+    QString operand;
+    bool negate;
+    bool active;
+    qint64 lastFired;
+};
+
+/* Matches game text on its own thread as soon as the parser emits it and
+   evaluates state conditions on every GameDataContainer change. Actions
+   run on the main thread. */
+class TriggerEngine : public WorkQueueThread<QString> {
+    Q_OBJECT
+
+public:
+    explicit TriggerEngine(QObject *parent = 0);
+    ~TriggerEngine();
+
+    void onProcess(const QString& data) override;
+
+    QString getVariable(const QString& name);
+
+private:
+    MainWindow* mainWindow;
+    AudioPlayer* audioPlayer;
+
+    QList<CompiledTrigger> textTriggers;
+    QList<CompiledTrigger> stateTriggers;
+    QMutex textMutex;
+
+    QHash<QString, QString> variables;
+    QElapsedTimer clock;
+    QRegExp rxRemoveTags;
+
+    bool compileState(CompiledTrigger& trigger);
+    bool evaluate(const CompiledTrigger& trigger, const QVariant& value);
+    bool coolingDown(CompiledTrigger& trigger);
+    QString expandCaptures(const QString& value, const QRegularExpressionMatch& match);
+    QString expandVariables(const QString& value);
+
+signals:
+    void fire(QString action, QString value);
+
+public slots:
+    /* called directly on the parser thread */
+    void addText(QByteArray text, bool prompt);
+    void stateChanged(QString field, QVariant value);
+    void reloadSettings();
+
+private slots:
+    void runAction(QString action, QString value);
+};
+
+#endif // TRIGGERENGINE_H
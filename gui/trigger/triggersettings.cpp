@@ -0,0 +1,80 @@
+#include "triggersettings.h"
+
+#include "clientsettings.h"
+
+#include <QGlobalStatic>
+
+Q_GLOBAL_STATIC(TriggerSettingsInstance, uniqueInstance)
+
+TriggerSettings* TriggerSettings::getInstance() {
+    return uniqueInstance;
+}
+
+TriggerSettings::TriggerSettings() {
+    clientSettings = ClientSettings::getInstance();
+    this->create();
+}
+
+void TriggerSettings::reInit() {
+    QMutexLocker locker(&m_mutex);
+    delete settings;
+    this->create();
+}
+
+void TriggerSettings::create() {
+    settings = new QSettings(clientSettings->profilePath() + "triggers.ini", QSettings::IniFormat);
+}
+
+void TriggerSettings::writeEntry(const TriggerSettingsEntry& entry) {
+    settings->setValue("enabled", entry.enabled);
+    settings->setValue("event", entry.event);
+    settings->setValue("pattern", entry.pattern);
+    settings->setValue("action", entry.action);
+    settings->setValue("value", entry.value);
+    settings->setValue("cooldown", entry.cooldown);
+}
+
+void TriggerSettings::setSettings(QList<TriggerSettingsEntry> entries) {
+    QMutexLocker locker(&m_mutex);
+    settings->remove("trigger");
+    settings->beginWriteArray("trigger");
+
+    for (int i = 0; i < entries.size(); ++i) {
+        settings->setArrayIndex(i);
+        this->writeEntry(entries.at(i));
+    }
+    settings->endArray();
+}
+
+void TriggerSettings::addParameter(TriggerSettingsEntry entry) {
+    QMutexLocker locker(&m_mutex);
+    int id = settings->value("trigger/size").toInt();
+
+    settings->beginWriteArray("trigger");
+    settings->setArrayIndex(id);
+    this->writeEntry(entry);
+    settings->endArray();
+}
+
+QList<TriggerSettingsEntry> TriggerSettings::getTriggers() {
+    QMutexLocker locker(&m_mutex);
+    QList<TriggerSettingsEntry> entries;
+
+    int size = settings->beginReadArray("trigger");
+    for (int i = 0; i < size; i++) {
+        settings->setArrayIndex(i);
+        entries.append(TriggerSettingsEntry(i,
+                settings->value("enabled", true).toBool(),
+                settings->value("event", "text").toString(),
+                settings->value("pattern", "").toString(),
+                settings->value("action", "command").toString(),
+                settings->value("value", "").toString(),
+                settings->value("cooldown", 0).toInt()));
+    }
+    settings->endArray();
+    return entries;
+}
+
+TriggerSettings::~TriggerSettings() {
+    delete settings;
+}
@@ -0,0 +1,39 @@
+#ifndef TRIGGERSETTINGS_H
+#define TRIGGERSETTINGS_H
+
+#include <QMutex>
+#include <QSettings>
+
+#include "trigger/triggersettingsentry.h"
+
+class ClientSettings;
+
+class TriggerSettings {
+    friend class TriggerSettingsInstance;
+
+public:
+    static TriggerSettings* getInstance();
+    ~TriggerSettings();
+
+    void reInit();
+
+    void addParameter(TriggerSettingsEntry entry);
+    QList<TriggerSettingsEntry> getTriggers();
+    void setSettings(QList<TriggerSettingsEntry> entries);
+
+private:
+    explicit TriggerSettings();
+
+    void create();
+    void writeEntry(const TriggerSettingsEntry& entry);
+
+    QSettings* settings;
+    ClientSettings* clientSettings;
+
+    QMutex m_mutex;
+};
+
+class TriggerSettingsInstance : public TriggerSettings {
+};
+
+#endif // TRIGGERSETTINGS_H
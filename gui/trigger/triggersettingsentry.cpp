@@ -0,0 +1,26 @@
+#include "triggersettingsentry.h"
+
+TriggerSettingsEntry::TriggerSettingsEntry() {
+    id = 0;
+    enabled = false;
+    cooldown = 0;
+}
+
+TriggerSettingsEntry::TriggerSettingsEntry(const int& id, const bool& enabled, const QString& event,
+        const QString& pattern, const QString& action, const QString& value, const int& cooldown) {
+    this->id = id;
+    this->enabled = enabled;
+    this->event = event;
+    this->pattern = pattern;
+    this->action = action;
+    this->value = value;
+    this->cooldown = cooldown;
+}
+
+const QString TriggerSettingsEntry::toString() {
+    return "TriggerSettingsEntry:[ id => " + QString::number(this->id) +
+            ", event => " + this->event +
+            ", pattern => " + this->pattern +
+            ", action => " + this->action +
+            ", value => " + this->value + " ]";
+}
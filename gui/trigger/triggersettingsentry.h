@@ -0,0 +1,32 @@
+#ifndef TRIGGERSETTINGSENTRY_H
+#define TRIGGERSETTINGSENTRY_H
+
+#include <QString>
+#include <QList>
+
+class TriggerSettingsEntry {
+
+public:
+    TriggerSettingsEntry();
+
+    TriggerSettingsEntry(const int& id, const bool& enabled, const QString& event, const QString& pattern,
+                         const QString& action, const QString& value, const int& cooldown);
+
+    const QString toString();
+
+    int id;
+    bool enabled;
+    // "text" - pattern is a regular expression matched against game lines,
+    // "state" - pattern is a condition on a game data field, e.g. "HEALTH < 50"
+    QString event;
+    QString pattern;
+    // command, echo, variable, timer or sound
+    QString action;
+    QString value;
+    // minimum time in ms between two firings
+    int cooldown;
+};
+
+typedef QList<TriggerSettingsEntry> TriggerSettingsEntryList;
+
+#endif // TRIGGERSETTINGSENTRY_H
@@ -0,0 +1,59 @@
+#include "uiupdatequeue.h"
+
+UiUpdateQueue* UiUpdateQueue::m_pInstance = NULL;
+
+UiUpdateQueue* UiUpdateQueue::Instance() {
+    if (!m_pInstance) {
+        m_pInstance = new UiUpdateQueue;
+    }
+    return m_pInstance;
+}
+
+UiUpdateQueue::UiUpdateQueue(QObject *parent) : QObject(parent) {
+    frameTimer = new QTimer(this);
+    frameTimer->setSingleShot(true);
+    frameTimer->setInterval(FRAME_INTERVAL_MS);
+
+    connect(frameTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+bool UiUpdateQueue::changed(const QString& key, const QVariant& value) {
+    QHash<QString, QVariant>::const_iterator it = rendered.constFind(key);
+    if(it != rendered.constEnd() && it.value() == value) {
+        return false;
+    }
+    rendered.insert(key, value);
+    return true;
+}
+
+void UiUpdateQueue::invalidate(const QString& key) {
+    rendered.remove(key);
+}
+
+void UiUpdateQueue::post(QObject* context, const QString& key, std::function<void()> render) {
+    // latest render for a key wins and runs after
+    // everything posted before it within the frame
+    if(pending.contains(key)) {
+        pendingOrder.removeOne(key);
+    }
+    pending.insert(key, Render {context, render});
+    pendingOrder.append(key);
+
+    if(!frameTimer->isActive()) {
+        frameTimer->start();
+    }
+}
+
+void UiUpdateQueue::flush() {
+    QHash<QString, Render> renders;
+    renders.swap(pending);
+    QStringList order;
+    order.swap(pendingOrder);
+
+    foreach(const QString& key, order) {
+        const Render& entry = renders[key];
+        if(!entry.context.isNull()) {
+            entry.render();
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef UIUPDATEQUEUE_H
+#define UIUPDATEQUEUE_H
+
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+#include <QVariant>
+
+#include <functional>
+
+/*
+ * Remembers the last rendered value for each widget key and
+ * collects pending renders so that widgets changed within the
+ * same frame are painted together. Only used from the GUI thread.
+ */
+class UiUpdateQueue : public QObject {
+    Q_OBJECT
+
+public:
+    static UiUpdateQueue* Instance();
+
+    bool changed(const QString& key, const QVariant& value);
+    void invalidate(const QString& key);
+
+    void post(QObject* context, const QString& key, std::function<void()> render);
+
+private:
+    UiUpdateQueue(QObject *parent = 0);
+    UiUpdateQueue(UiUpdateQueue const& copy);
+    UiUpdateQueue& operator = (UiUpdateQueue const& copy);
+    static UiUpdateQueue* m_pInstance;
+
+    static const int FRAME_INTERVAL_MS = 16;
+
+    struct Render {
+        QPointer<QObject> context;
+        std::function<void()> render;
+    };
+
+    QHash<QString, QVariant> rendered;
+    QHash<QString, Render> pending;
+    QStringList pendingOrder;
+
+    QTimer* frameTimer;
+
+private slots:
+    void flush();
+};
+
+#endif // UIUPDATEQUEUE_H
@@ -5,10 +5,12 @@
 
 #include "mainwindow.h"
 #include "clientsettings.h"
+#include "uiupdatequeue.h"
 
 VitalsBar::VitalsBar(QObject *parent) : QObject(parent) {
     mainWindow = (MainWindow*)parent;
     clientSettings = ClientSettings::getInstance();
+    uiUpdateQueue = UiUpdateQueue::Instance();
 }
 
 void VitalsBar::add() {
@@ -106,42 +108,45 @@ void VitalsBar::createMenuEntry(bool checked) {
 
 void VitalsBar::updateVitals(QString name, QString value) {
     int intValue = value.toInt();
+    if(!uiUpdateQueue->changed("vitalsBar/" + name, intValue)) return;
+
     if(name == "health") {
         QString color = "#9BCA3E";
         if(intValue < 80) color = "#FEEB51";
         if(intValue < 50) color = "#FFB92A";
         if(intValue < 30) color = "#ED5314";
 
-        QPalette p = health->palette();
-        p.setColor(QPalette::Highlight, color);
-        health->setPalette(p);
+        uiUpdateQueue->post(health, "vitalsBar/health", [=]() {
+            QPalette p = health->palette();
+            p.setColor(QPalette::Highlight, color);
+            health->setPalette(p);
 
-        health->setValue(intValue);
-        health->setFormat("H: " + QString::number(intValue) + "%");
-        health->setToolTip("Health: " + value + "%");
-        health->repaint();
+            this->renderBar(health, "H", intValue, "Health: " + value + "%");
+        });
     } else if(name == "concentration") {
-        concentration->setValue(intValue);
-        concentration->setFormat("C: " + QString::number(intValue) + "%");
-        concentration->setToolTip("Concentration: " + value + "%");
-        concentration->repaint();
+        uiUpdateQueue->post(concentration, "vitalsBar/concentration", [=]() {
+            this->renderBar(concentration, "C", intValue, "Concentration: " + value + "%");
+        });
     } else if(name == "stamina") {
-        fatigue->setValue(intValue);
-        fatigue->setFormat("F: " + QString::number(intValue) + "%");
-        fatigue->setToolTip("Fatigue: " + value + "%");
-        fatigue->repaint();
+        uiUpdateQueue->post(fatigue, "vitalsBar/stamina", [=]() {
+            this->renderBar(fatigue, "F", intValue, "Fatigue: " + value + "%");
+        });
     } else if(name == "spirit") {
-        spirit->setValue(intValue);
-        spirit->setFormat("S: " + QString::number(intValue) + "%");
-        spirit->setToolTip("Spirit: " + value + "%");
-        spirit->repaint();
+        uiUpdateQueue->post(spirit, "vitalsBar/spirit", [=]() {
+            this->renderBar(spirit, "S", intValue, "Spirit: " + value + "%");
+        });
     } else if(name == "mana") {
-        mana->setValue(intValue);
-        mana->setFormat("M: " + QString::number(intValue) + "%");
-        mana->setToolTip("Mana: " + value + "%");
-        mana->repaint();
+        uiUpdateQueue->post(mana, "vitalsBar/mana", [=]() {
+            this->renderBar(mana, "M", intValue, "Mana: " + value + "%");
+        });
     }
 }
 
+void VitalsBar::renderBar(QProgressBar* bar, QString prefix, int value, QString toolTip) {
+    bar->setValue(value);
+    bar->setFormat(prefix + ": " + QString::number(value) + "%");
+    bar->setToolTip(toolTip);
+}
+
 VitalsBar::~VitalsBar() {
 }
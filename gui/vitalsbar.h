@@ -7,6 +7,7 @@
 
 class MainWindow;
 class ClientSettings;
+class UiUpdateQueue;
 
 class VitalsBar : public QObject {
     Q_OBJECT
@@ -24,6 +25,7 @@ private:
     MainWindow* mainWindow;
 
     ClientSettings* clientSettings;
+    UiUpdateQueue* uiUpdateQueue;
 
     QAction* action;
 
@@ -38,6 +40,7 @@ private:
     QFrame* addFrame(QProgressBar* bar);
     void createMenuEntry(bool checked);
     QProgressBar* toolBar(const char* obName, QString bgColor);
+    void renderBar(QProgressBar* bar, QString prefix, int value, QString toolTip);
 
 signals:
 
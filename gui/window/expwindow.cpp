@@ -4,6 +4,7 @@
 #include "mainwindow.h"
 #include "windowfacade.h"
 #include "gridwindow.h"
+#include "gridmodel.h"
 #include "gridwriterthread.h"
 #include "gamedatacontainer.h"
 #include "defaultvalues.h"
@@ -15,9 +16,9 @@ ExpWindow::ExpWindow(QObject *parent) : QObject(parent) {
     gameDataContainer = GameDataContainer::Instance();
 
     dock = GridWindowFactory(parent).createWindow(DOCK_TITLE_EXP);
-    table = ((QTableWidget*)dock->widget());
 
     window = (GridWindow*)dock->widget();
+    model = window->getModel();
 
     showGained = window->getWindowParameter("showGained", true).value<bool>();
 
@@ -28,7 +29,7 @@ ExpWindow::ExpWindow(QObject *parent) : QObject(parent) {
     this->addContextMenu();
 
     connect(windowFacade, SIGNAL(updateWindowSettings()), writer, SLOT(updateSettings()));
-    connect(writer, SIGNAL(writeGrid(GridItems)), this, SLOT(writeExpWindow(GridItems)));
+    connect(writer, SIGNAL(writeGridItem(QString, QString)), this, SLOT(writeExpItem(QString, QString)));
 }
 
 void ExpWindow::addContextMenu() {
@@ -58,49 +59,55 @@ void ExpWindow::write(QString name, QString text) {
 }
 
 void ExpWindow::refresh() {
-    int rows = table->rowCount();
+    int rows = model->rowCount();
     for(int i = 0; i < rows; i++) {
-        QLabel* label = (QLabel*)table->cellWidget(i, 0);
-        QString key = label->objectName();
-        QString value = label->property("plainText").value<QString>();
-        this->writeRow(key, value, i);
+        this->writeRow(model->name(i), model->value(i));
     }
 }
 
-void ExpWindow::writeExpWindow(GridItems items) {
-    int size = items.size();
-    table->setRowCount(size);
-    int row = 0;
-    foreach(QString key, items.keys()) {
-        QString value = items.value(key);
-        this->writeRow(key, value, row);
-        row++;
+void ExpWindow::writeExpItem(QString name, QString value) {
+    if(value.isEmpty()) {
+        model->removeItem(name);
+        gained.remove(name);
+    } else {
+        this->writeRow(name, value);
     }
+    this->refreshGained();
 }
 
-void ExpWindow::writeRow(QString key, QString value, int row) {
+void ExpWindow::refreshGained() {
+    // clear gain indicators that expired since the row was written
+    foreach(QString key, gained) {
+        if(!gameDataContainer->isExpGained(key)) {
+            int row = model->indexOf(key);
+            if(row != -1) {
+                this->writeRow(key, model->value(row));
+            } else {
+                gained.remove(key);
+            }
+        }
+    }
+}
+
+void ExpWindow::writeRow(QString key, QString value) {
     QString text = "<span style=\"white-space:pre-wrap; \">";
     addGainedIndicator(key, text);
     text += value + "</span>";
 
-    QLabel* item = (QLabel*)table->cellWidget(row, 0);
-    if(item == NULL) {
-        item = window->gridValueLabel(table);
-        table->setCellWidget(row, 0, item);
-    }
-    item->setProperty("plainText", value);
-    item->setText(text);
-    item->setObjectName(key);
-    window->track(key, item);
+    model->setItem(key, value, text);
 }
 
 void ExpWindow::addGainedIndicator(QString key, QString &text) {
     if(showGained) {
         if(gameDataContainer->isExpGained(key)) {
+            gained.insert(key);
             text += "(+)";
         } else {
+            gained.remove(key);
             text += "&nbsp;&nbsp;&nbsp;";
         }
+    } else {
+        gained.remove(key);
     }
 }
 
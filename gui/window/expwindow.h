@@ -3,8 +3,7 @@
 
 #include <QObject>
 #include <QDockWidget>
-#include <QTableWidget>
-#include <QMap>
+#include <QSet>
 #include <QAction>
 #include <textutils.h>
 
@@ -12,12 +11,9 @@ class MainWindow;
 class WindowFacade;
 class GridWindow;
 class GridWriterThread;
+class GridModel;
 class GameDataContainer;
 
-typedef QMap<QString, QString> GridItems;
-
-class GridWriterThread;
-
 class ExpWindow : public QObject {
     Q_OBJECT
 
@@ -36,18 +32,20 @@ private:
     QAction* gainedAct;
 
     QDockWidget* dock;
-    QTableWidget* table;
+    GridModel* model;
 
     bool showGained;
+    QSet<QString> gained;
 
     void addContextMenu();
     void addGainedIndicator(QString key, QString &text);
-    void writeRow(QString key, QString value, int row);
+    void writeRow(QString key, QString value);
+    void refreshGained();
     void refresh();
 
 public slots:
     void write(QString name, QString text);
-    void writeExpWindow(GridItems items);
+    void writeExpItem(QString name, QString value);
     void changeShowGained();
 };
 
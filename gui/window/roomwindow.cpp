@@ -29,19 +29,20 @@ QDockWidget* RoomWindow::getDockWidget() {
 }
 
 void RoomWindow::write() {
-    QString roomText = "";
-
-    QString desc = gameDataContainer->getRoomDesc();
-    roomText += desc.isEmpty() ? "" : desc + "\n";
+    QStringList current;
+    current << gameDataContainer->getRoomDesc()
+            << gameDataContainer->getRoomObjsData()
+            << gameDataContainer->getRoomPlayers()
+            << gameDataContainer->getRoomExits();
 
-    QString objs = gameDataContainer->getRoomObjsData();
-    roomText += objs.isEmpty() ? "" : objs + "\n";
+    // unchanged room; nothing to repaint
+    if(current == sections) return;
+    sections = current;
 
-    QString players = gameDataContainer->getRoomPlayers();
-    roomText += players.isEmpty() ? "" : players + "\n";
-
-    QString exits = gameDataContainer->getRoomExits();
-    roomText += exits.isEmpty() ? "" : exits + "\n";
+    QString roomText = "";
+    foreach(const QString& section, sections) {
+        roomText += section.isEmpty() ? "" : section + "\n";
+    }
 
     writer->addText(roomText);
     if(!writer->isRunning()) writer->start();
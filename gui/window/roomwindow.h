@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QDockWidget>
+#include <QStringList>
 
 class MainWindow;
 class WindowFacade;
@@ -28,6 +29,8 @@ private:
 
     QDockWidget* dock;
 
+    QStringList sections;
+
 public slots:
     void write();
     void setTitle(QString title);
@@ -37,6 +37,7 @@
 #include "scriptservice.h"
 #include "genericwindow.h"
 #include "windowwriterthread.h"
+#include "uiupdatequeue.h"
 
 QStringList WindowFacade::staticWindows = QStringList() << "inv" << "familiar" << "thoughts"
     << "logons" << "death" << "assess" << "conversation" << "whispers" << "talk" << "experience"
@@ -51,6 +52,7 @@ WindowFacade::WindowFacade(QObject *parent) : QObject(parent) {
     clientSettings = ClientSettings::getInstance();
     settings = HighlightSettings::getInstance();
     generalSettings = GeneralSettings::getInstance();
+    uiUpdateQueue = UiUpdateQueue::Instance();
     mainLogger = new MainLogger(this);
 
     rxRemoveTags.setPattern("<[^>]*>");
@@ -123,14 +125,8 @@ void WindowFacade::setDockFontColor(QColor fontColor) {
             p = ((QPlainTextEdit*)dock->widget())->palette();
             p.setColor(QPalette::Text, fontColor);
             ((QPlainTextEdit*)dock->widget())->setPalette(p);
-        } else if(qobject_cast<QTableWidget*>(dock->widget()) != NULL) {
-            QTableWidget* tableWidget = (QTableWidget*)dock->widget();
-            for(int i = 0; i < tableWidget->rowCount(); i++) {
-                QLabel* widget = (QLabel*)tableWidget->cellWidget(i, 0);
-                QPalette p = widget->palette();
-                p.setColor(QPalette::Text, fontColor);
-                widget->setPalette(p);
-            }
+        } else if(qobject_cast<GridWindow*>(dock->widget()) != NULL) {
+            ((GridWindow*)dock->widget())->setTextColor(fontColor);
         }
     }
 
@@ -148,22 +144,8 @@ void WindowFacade::setDockBackground(QColor backgroundColor) {
             p = ((QPlainTextEdit*)dock->widget())->viewport()->palette();
             p.setColor(QPalette::Base, backgroundColor);
             ((QPlainTextEdit*)dock->widget())->viewport()->setPalette(p);
-        } else if(qobject_cast<QTableWidget*>(dock->widget()) != NULL) {
-            QTableWidget* tableWidget = (QTableWidget*)dock->widget();
-
-            QPalette p;
-            p = tableWidget->viewport()->palette();
-            p.setColor(QPalette::Base, backgroundColor);
-            tableWidget->viewport()->setPalette(p);
-
-            for(int i = 0; i < tableWidget->rowCount(); i++) {
-                QWidget* widget = tableWidget->cellWidget(i, 0);
-                QLabel* label = ((QLabel*)widget);
-
-                p = label->palette();
-                p.setColor(QPalette::Base, backgroundColor);
-                ((QLabel*)widget)->setPalette(p);
-            }
+        } else if(qobject_cast<GridWindow*>(dock->widget()) != NULL) {
+            ((GridWindow*)dock->widget())->setBackgroundColor(backgroundColor);
         }
     }
 
@@ -181,15 +163,9 @@ void WindowFacade::setDockFont(QFont font) {
         QVariant windowFont = dock->widget()->property(WINDOW_FONT_ID);
         if(qobject_cast<QPlainTextEdit*>(dock->widget()) != NULL) {
             ((QPlainTextEdit*)dock->widget())->setFont(windowFont.isNull() ? font : windowFont.value<QFont>());
-        } else if(qobject_cast<QTableWidget*>(dock->widget()) != NULL) {
+        } else if(qobject_cast<GridWindow*>(dock->widget()) != NULL) {
             if(windowFont.isNull()) {
-                QTableWidget* tableWidget = (QTableWidget*)dock->widget();
-                for(int i = 0; i < tableWidget->rowCount(); i++) {
-                    QWidget* widget = tableWidget->cellWidget(i, 0);
-                    if(widget != NULL) {
-                        ((QLabel*)widget)->setFont(windowFont.isNull() ? font : windowFont.value<QFont>());
-                    }
-                }
+                ((GridWindow*)dock->widget())->setGridFont(font);
             }
         }
     }
@@ -395,7 +371,11 @@ void WindowFacade::scriptRunning(bool state) {
 }
 
 void WindowFacade::paintCompass() {
-    compassView->paint(compass);
+    if(!uiUpdateQueue->changed("compass", compass->getState())) return;
+
+    uiUpdateQueue->post(compassView, "compass", [=]() {
+        compassView->paint(compass);
+    });
 }
 
 void WindowFacade::gameWindowResizeEvent(GameWindow* gameWindow) {
@@ -408,7 +388,7 @@ void WindowFacade::updateMapWindow(QString hash) {
 
 void WindowFacade::writeGameText(QByteArray text, bool prompt) {
     if(prompt && writePrompt) {
-        mainWindow->getScriptService()->writeScriptText(text);
+        mainWindow->getScriptService()->writeScriptText(text, true);
         mainWriter->addText(text);
         this->logGameText(text, MainLogger::PROMPT);
         writePrompt = false;
@@ -451,6 +431,7 @@ void WindowFacade::registerStreamWindow(QString id, QString title) {
     ((GenericWindow*)streamWindow->widget())->setStream(true);
     mainWindow->addDockWidgetMainWindow(Qt::RightDockWidgetArea, streamWindow);
     streamWindows.insert(id, streamWindow);
+    this->addStreamWindowName(id);
 
     WindowWriterThread* streamWriter = new WindowWriterThread(mainWindow, (GenericWindow*)streamWindow->widget());
     connect(this, SIGNAL(updateWindowSettings()), streamWriter, SLOT(updateSettings()));
@@ -469,10 +450,26 @@ void WindowFacade::removeStreamWindow(QString id) {
     mainWindow->removeDockWidgetMainWindow(window);
     delete window;
     streamWindows.remove(id);
+    this->removeStreamWindowName(id);
 }
 
+/* safe to call from any thread */
 QList<QString> WindowFacade::getStreamWindowNames() {
-    return streamWindows.keys();
+    QMutexLocker locker(&streamWindowNamesMutex);
+    return streamWindowNames;
+}
+
+/* also called by the api thread when it queues a change, so the next
+   WINDOW_LIST sees it before the window itself exists */
+void WindowFacade::addStreamWindowName(QString id) {
+    if(staticWindows.contains(id)) return;
+    QMutexLocker locker(&streamWindowNamesMutex);
+    if(!streamWindowNames.contains(id)) streamWindowNames << id;
+}
+
+void WindowFacade::removeStreamWindowName(QString id) {
+    QMutexLocker locker(&streamWindowNamesMutex);
+    streamWindowNames.removeAll(id);
 }
 
 void WindowFacade::writeStreamWindow(QString id, QString text) {
@@ -5,6 +5,7 @@
 #include <QGraphicsPixmapItem>
 #include <QGraphicsProxyWidget>
 #include <QPlainTextEdit>
+#include <QMutex>
 
 class MainWindow;
 class GameWindow;
@@ -20,6 +21,7 @@ class MapFacade;
 class CompassView;
 class Compass;
 class WindowWriterThread;
+class UiUpdateQueue;
 
 class RoomWindow;
 class ArrivalsWindow;
@@ -35,7 +37,6 @@ class CombatWindow;
 class DictionaryWindow;
 
 typedef QList<QString> DirectionsList;
-typedef QMap<QString, QString> GridItems;
 
 class WindowFacade : public QObject {
     Q_OBJECT
@@ -100,6 +101,8 @@ public slots:
     void writeStreamWindow(QString id, QString text);
     void clearStreamWindow(QString id);
     QList<QString> getStreamWindowNames();
+    void addStreamWindowName(QString id);
+    void removeStreamWindowName(QString id);
 
     void reloadSettings();
 
@@ -119,6 +122,7 @@ private:
     Highlighter* highlighter;
     HighlightSettings* settings;
     GeneralSettings* generalSettings;
+    UiUpdateQueue* uiUpdateQueue;
 
     RoomWindow* roomWindow;
     ArrivalsWindow* arrivalsWindow;
@@ -135,6 +139,9 @@ private:
 
     QList<QDockWidget*> dockWindows;
     QHash<QString, QDockWidget*> streamWindows;
+    // names copied for the api thread, which must not wait on the gui thread
+    QList<QString> streamWindowNames;
+    QMutex streamWindowNamesMutex;
 
     CompassView* compassView;
 
@@ -27,6 +27,7 @@ WindowWriterThread::WindowWriterThread(QObject *parent, WindowInterface* window)
 void WindowWriterThread::updateSettings() {   
     highlighter->reloadSettings();
     alter->reloadSettings();
+    settingsChanged = 1;
 }
 
 void WindowWriterThread::addText(QString text) {
@@ -37,6 +38,13 @@ QString WindowWriterThread::process(QString text, QString win) {
     return highlighter->highlight(alter->addLink(alter->substitute(text, win), win));
 }
 
+QString WindowWriterThread::processCached(const QString& line, const QString& win, QHash<QString, QString>& cache) {
+    QHash<QString, QString>::const_iterator it = lineCache.constFind(line);
+    QString processed = it != lineCache.constEnd() ? it.value() : this->process(line, win);
+    cache.insert(line, processed);
+    return processed;
+}
+
 void WindowWriterThread::onProcess(const QString& data) {
     if(alter->ignore(data, window->getObjectName())) return;
     if(window->stream()) {
@@ -48,16 +56,27 @@ void WindowWriterThread::onProcess(const QString& data) {
     } else if(window->append()) {
         setText(this->process(data, window->getObjectName()));
     } else {
+        if(settingsChanged.testAndSetOrdered(1, 0)) {
+            lineCache.clear();
+            lastText.clear();
+        }
+        // only lines not present in the previous write go through alter and highlighter
+        QHash<QString, QString> cache;
         QString text = "";
         QList<QString> lines = data.split('\n');
         int size = lines.size() - 1;
         for(int i = 0; i < size; ++i) {
-            text += this->process(lines.at(i), window->getObjectName());
+            text += this->processCached(lines.at(i), window->getObjectName(), cache);
 
             if(i < size - 1) {
                 text += "\n";
             }
         }
+        lineCache = cache;
+
+        if(text == lastText) return;
+        lastText = text;
+
         emit clearText();
         setText(text);
     }
@@ -2,6 +2,8 @@
 #define WINDOWWRITERTHREAD_H
 
 #include <QString>
+#include <QHash>
+#include <QAtomicInt>
 #include <QPlainTextEdit>
 
 #include "workqueuethread.h"
@@ -31,7 +33,13 @@ private:
     QRegExp rxRemoveTags;
     WindowInterface *window;
 
+    // processed lines of the last non-append write, keyed by raw line
+    QHash<QString, QString> lineCache;
+    QString lastText;
+    QAtomicInt settingsChanged;
+
     QString process(QString text, QString win);
+    QString processCached(const QString& line, const QString& win, QHash<QString, QString>& cache);
 
     void setText(QString);
 
@@ -13,6 +13,7 @@ XmlParserThread::XmlParserThread(QObject *parent, GameDataContainer* dataContain
     initRoundtime = false;
     initCastTime = false;
     prompt = false;
+    roomChanged = false;
 
     charName = "";
 
@@ -234,6 +235,8 @@ bool XmlParserThread::filterDataTags(QDomElement root, QDomNode n) {
             }
             prompt = true;
             gameText += root.text().trimmed().toUtf8();
+            emit updatePrompt(root.text().trimmed(), e.attribute("time").toInt());
+            this->commitRoom();
             this->runScheduledEvents();
         } else if(e.tagName() == "compass") {
             /* filter compass */
@@ -246,6 +249,7 @@ bool XmlParserThread::filterDataTags(QDomElement root, QDomNode n) {
             qSort(directions);
 
             gameDataContainer->setCompassDirections(directions);
+            this->commitRoom();
 
             QString text = gameDataContainer->getRoomName() +
                     TextUtils::stripMapSpecial(gameDataContainer->getRoomDesc())
@@ -370,7 +374,8 @@ bool XmlParserThread::filterDataTags(QDomElement root, QDomNode n) {
                     TextUtils::plainToHtml(roomExtra);
                     gameDataContainer->setRoomExtra(roomExtra);
                 }
-                emit updateRoomWindow();
+                // room components arrive one by one; written out on compass or prompt
+                roomChanged = true;
             }
         } else if(e.tagName() == "clearStream") {
             if(e.attribute("id") == "percWindow") {
@@ -615,6 +620,13 @@ QString XmlParserThread::parseTalk(QDomElement element) {
     return "";
 }
 
+void XmlParserThread::commitRoom() {
+    if(roomChanged) {
+        roomChanged = false;
+        emit updateRoomWindow();
+    }
+}
+
 void XmlParserThread::runScheduledEvents() {
     if(scheduled.empty()) return;
 
@@ -59,6 +59,7 @@ private:
     bool initRoundtime;
     bool initCastTime;
     bool prompt;
+    bool roomChanged;
 
     QString streamCache;
 
@@ -89,6 +90,7 @@ private:
 
     QString traverseXmlNode(QDomElement element, QString text);
 
+    void commitRoom();
     void runScheduledEvents();
     void runEvent(QString event, QVariant data);
 
@@ -123,6 +125,8 @@ signals:
     void setTimer(int);
     void setCastTimer(int);
 
+    void updatePrompt(QString, int);
+
     void writeScriptMessage(QByteArray);
     void setMainTitle(QString);
     void writeText(QByteArray, bool);
@@ -0,0 +1,15 @@
+// Counts roundtimes, in process javascript version of countrt.rb
+
+var rtList = [];
+
+onLine(function(line) {
+  if (line.indexOf("Roundtime") === 0) {
+    rtList.push(get("RT"));
+    echo("rt: " + get("RT") + ", count: " + rtList.length);
+  }
+});
+
+for (var i = 0; i < 10000; i++) {
+  put("attack");
+  waitForRt();
+}
@@ -1,5 +1,7 @@
 require 'socket'
 require "erb"
+require "json"
+require "shared"
 
 class Rt
   # Round time
@@ -9,6 +11,7 @@ class Rt
   #   echo Rt::value
   #   => 5
   def self.value
+    return SharedData::int(:rt) if SharedData::loaded?
     $_api_socket.puts "GET RT\n"
     $_api_socket.gets('\0').chomp('\0').to_i
   end
@@ -22,6 +25,7 @@ class Ct
   #   echo Ct::value
   #   => 5
   def self.value
+    return SharedData::int(:ct) if SharedData::loaded?
     $_api_socket.puts "GET CT\n"
     $_api_socket.gets('\0').chomp('\0').to_i
   end
@@ -35,6 +39,7 @@ class Spell
   #   echo Spell::active
   #   => ["Khri Sagacity  (6 roisaen)", "Khri Shadowstep  (34 roisaen)", "Khri Skulk"]
   def self.active
+    return API::State::value(:active_spells) if API::State::subscribed?(:active_spells)
     $_api_socket.puts "GET ACTIVE_SPELLS\n"
     $_api_socket.gets('\0').chomp('\0').split("\n")
   end
@@ -76,6 +81,7 @@ class Wield
   #   echo Wield::right
   #   => fuzzy sharks
   def self.right()
+    return SharedData::string(:wield_right) if SharedData::loaded? && SharedData::complete?(:wield_right)
     $_api_socket.puts "GET WIELD_RIGHT\n"
     $_api_socket.gets('\0').chomp('\0').to_s
   end
@@ -86,6 +92,7 @@ class Wield
   # @example Using wield right noun in script.
   #   put "put my #{Wield::right_noun} in my backpack"
   def self.right_noun()
+    return SharedData::string(:wield_right_noun) if SharedData::loaded? && SharedData::complete?(:wield_right_noun)
     $_api_socket.puts "GET WIELD_RIGHT_NOUN\n"
     $_api_socket.gets('\0').chomp('\0').to_s
   end
@@ -97,6 +104,7 @@ class Wield
   #   echo Wield::left
   #   => ""
   def self.left()
+    return SharedData::string(:wield_left) if SharedData::loaded? && SharedData::complete?(:wield_left)
     $_api_socket.puts "GET WIELD_LEFT\n"
     $_api_socket.gets('\0').chomp('\0').to_s
   end
@@ -108,6 +116,7 @@ class Wield
   #   echo Wield::left_noun
   #   => ""
   def self.left_noun()
+    return SharedData::string(:wield_left_noun) if SharedData::loaded? && SharedData::complete?(:wield_left_noun)
     $_api_socket.puts "GET WIELD_LEFT_NOUN\n"
     $_api_socket.gets('\0').chomp('\0').to_s
   end
@@ -159,6 +168,7 @@ class Room
   #   echo Room::title
   #   => [Mycthengelde, Flatlands]
   def self.title
+    return SharedData::string(:room_title) if SharedData::loaded? && SharedData::complete?(:room_title)
     $_api_socket.puts "GET ROOM_TITLE\n"
     $_api_socket.gets('\0').chomp('\0').to_s
   end
@@ -242,6 +252,7 @@ class Vitals
   #     put retreat
   #   end
   def self.health
+    return SharedData::int(:health) if SharedData::loaded?
     $_api_socket.puts "GET HEALTH\n"
     $_api_socket.gets('\0').chomp('\0').to_i
   end
@@ -253,6 +264,7 @@ class Vitals
   #   echo Vitals::concentration
   #   => 100
   def self.concentration
+    return SharedData::int(:concentration) if SharedData::loaded?
     $_api_socket.puts "GET CONCENTRATION\n"
     $_api_socket.gets('\0').chomp('\0').to_i
   end
@@ -264,6 +276,7 @@ class Vitals
   #   echo Vitals::fatigue
   #   => 100
   def self.fatigue
+    return SharedData::int(:fatigue) if SharedData::loaded?
     $_api_socket.puts "GET FATIGUE\n"
     $_api_socket.gets('\0').chomp('\0').to_i
   end
@@ -274,6 +287,7 @@ class Vitals
   # @example Using spirit value in script.
   #   echo Vitals::spirit
   def self.spirit
+    return SharedData::int(:spirit) if SharedData::loaded?
     $_api_socket.puts "GET SPIRIT\n"
     $_api_socket.gets('\0').chomp('\0').to_i
   end
@@ -287,6 +301,7 @@ class Status
   #   echo Status::standing
   #   => 1
   def self.standing
+    return SharedData::flag(:standing) if SharedData::loaded?
     $_api_socket.puts "GET STANDING\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -298,6 +313,7 @@ class Status
   #   echo Status::kneeling
   #   => 0
   def self.kneeling
+    return SharedData::flag(:kneeling) if SharedData::loaded?
     $_api_socket.puts "GET KNEELING\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -309,6 +325,7 @@ class Status
   #   echo Status::sitting
   #   => 0
   def self.sitting
+    return SharedData::flag(:sitting) if SharedData::loaded?
     $_api_socket.puts "GET SITTING\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -320,6 +337,7 @@ class Status
   #   echo Status::prone
   #   => 0
   def self.prone
+    return SharedData::flag(:prone) if SharedData::loaded?
     $_api_socket.puts "GET PRONE\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -331,6 +349,7 @@ class Status
   #   echo Status::stunned
   #   => 0
   def self.stunned
+    return SharedData::flag(:stunned) if SharedData::loaded?
     $_api_socket.puts "GET STUNNED\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -342,6 +361,7 @@ class Status
   #   echo Status::dead
   #   => 0
   def self.dead
+    return SharedData::flag(:dead) if SharedData::loaded?
     $_api_socket.puts "GET DEAD\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -353,6 +373,7 @@ class Status
   #   echo Status::bleeding
   #   => 1
   def self.bleeding
+    return SharedData::flag(:bleeding) if SharedData::loaded?
     $_api_socket.puts "GET BLEEDING\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -366,6 +387,7 @@ class Status
   #   end
   #   => 1
   def self.hidden
+    return SharedData::flag(:hidden) if SharedData::loaded?
     $_api_socket.puts "GET HIDDEN\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -377,6 +399,7 @@ class Status
   #   echo Status::invisible
   #   => 0
   def self.invisible
+    return SharedData::flag(:invisible) if SharedData::loaded?
     $_api_socket.puts "GET INVISIBLE\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -388,6 +411,7 @@ class Status
   #   echo Status::webbed
   #   => 0
   def self.webbed
+    return SharedData::flag(:webbed) if SharedData::loaded?
     $_api_socket.puts "GET WEBBED\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -399,6 +423,7 @@ class Status
   #   echo Status::joined
   #   => 1
   def self.joined
+    return SharedData::flag(:joined) if SharedData::loaded?
     $_api_socket.puts "GET JOINED\n"
     $_api_socket.gets('\0').chomp('\0').to_i.eql?(1)
   end
@@ -420,6 +445,26 @@ class Map
     $_api_socket.gets('\0').chomp('\0').split(",")
   end
 
+  # Route
+  #
+  # Moves from the current room to a room in any zone, crossing zones
+  # where the maps connect.
+  #
+  # @param [String] target location note, or zone id when room is given
+  # @param [Integer] room destination room id
+  # @return [Array] list of moves to destination (empty if no route found)
+  # @example Route to a named location
+  #   echo Map::route "NE Gate"
+  #   => ["north", "go gate", "east"]
+  # @example Route to a room in another zone
+  #   echo Map::route "7", 42
+  def self.route(target, room = nil)
+    query = ERB::Util.url_encode(target)
+    query += "&#{ERB::Util.url_encode(room)}" unless room.nil?
+    $_api_socket.puts "MAP_GET ROUTE?#{query}\n"
+    $_api_socket.gets('\0').chomp('\0').split(",")
+  end
+
   # Zones
   #
   # @return [Array] list of available zones
@@ -461,6 +506,7 @@ class Client
   #
   # @return [String] current character name
   def self.char_name
+    return SharedData::string(:char_name) if SharedData::loaded? && SharedData::complete?(:char_name)
     $_api_socket.puts "GET CHAR_NAME\n"
     $_api_socket.gets('\0').chomp('\0').to_s
   end
@@ -615,4 +661,54 @@ class Client
     $_api_socket.puts "CLIENT TRAY_WRITE?#{ERB::Util.url_encode(msg)}\n"
     $_api_socket.gets('\0').chomp('\0').to_i
   end
-end
\ No newline at end of file
+end
+
+class Snapshot
+  # Several values read at once
+  #
+  # @param [Array] fields value names as used by GET, e.g. "RT", "EXP_RANK?climbing"
+  # @return [Hash] values keyed by field name
+  # @example Reading vitals in one request.
+  #   echo Snapshot::get("HEALTH", "FATIGUE")
+  #   => {"HEALTH"=>100, "FATIGUE"=>96}
+  def self.get(*fields)
+    API::Framed.request({:get => fields.flatten.map(&:to_s)})
+  end
+
+  # Vitals snapshot
+  #
+  # @return [Hash] :health, :concentration, :fatigue, :spirit
+  # @example Using vitals snapshot in script.
+  #   echo Snapshot::vitals[:health]
+  #   => 100
+  def self.vitals
+    symbolize get("HEALTH", "CONCENTRATION", "FATIGUE", "SPIRIT")
+  end
+
+  # Status snapshot
+  #
+  # @return [Hash] :standing, :sitting, :kneeling, :prone, :stunned, :dead,
+  #   :bleeding, :hidden, :invisible, :webbed, :joined
+  # @example Using status snapshot in script.
+  #   status = Snapshot::status
+  #   put "stand" unless status[:standing]
+  def self.status
+    symbolize get("STANDING", "SITTING", "KNEELING", "PRONE", "STUNNED", "DEAD",
+                  "BLEEDING", "HIDDEN", "INVISIBLE", "WEBBED", "JOINED")
+  end
+
+  # Wield snapshot
+  #
+  # @return [Hash] :wield_right, :wield_right_noun, :wield_left, :wield_left_noun
+  # @example Using wield snapshot in script.
+  #   echo Snapshot::wield[:wield_right]
+  #   => fuzzy sharks
+  def self.wield
+    symbolize get("WIELD_RIGHT", "WIELD_RIGHT_NOUN", "WIELD_LEFT", "WIELD_LEFT_NOUN")
+  end
+
+  # @private
+  def self.symbolize(values)
+    Hash[values.map { |key, value| [key.downcase.to_sym, value] }]
+  end
+end
@@ -88,6 +88,7 @@ class Observer
         event[k] = Regexp.new(v.join('|'))
       end
     }
+    API::Filter::add event.values
     @events << event
   end
 
@@ -0,0 +1,75 @@
+require 'fiddle'
+
+# Reads game state from the snapshot the client publishes in shared memory
+# (layout in shared/shareddata.h). Falls back to the api socket when the
+# reader library or the snapshot is not available.
+#
+# @api private
+module SharedData
+  INTS = {:rt => 0, :ct => 1, :health => 2, :concentration => 3, :spirit => 4,
+          :fatigue => 5, :mana => 6, :room_id => 7}
+  FLAGS = {:standing => 0, :sitting => 1, :kneeling => 2, :prone => 3, :stunned => 4,
+           :bleeding => 5, :hidden => 6, :invisible => 7, :webbed => 8, :joined => 9, :dead => 10}
+  STRINGS = {:char_name => 0, :wield_right => 1, :wield_right_noun => 2, :wield_left => 3,
+             :wield_left_noun => 4, :room_title => 5, :room_exits => 6, :room_zone => 7}
+  STRING_SIZE = 256
+
+  LIBRARIES = ["libshared.so", "libshared.dylib", "shared.dll"]
+
+  def self.path
+    File.open("#{File.dirname(__FILE__)}/../../api.ini", 'r') do |inFile|
+      section = nil
+      inFile.each_line do |line|
+        section = line.strip if line.start_with? "["
+        return line.partition('=').last.strip if section == "[SharedData]" && line.start_with?("path=")
+      end
+    end
+    ""
+  rescue SystemCallError
+    ""
+  end
+
+  def self.load
+    path = SharedData::path
+    return false if path.empty?
+
+    dir = "#{File.dirname(__FILE__)}/../.."
+    library = LIBRARIES.map { |name| "#{dir}/#{name}" }.find { |file| File.exist? file }
+    return false if library.nil?
+
+    lib = Fiddle.dlopen(library)
+    @int = Fiddle::Function.new(lib['shared_int'], [Fiddle::TYPE_INT], Fiddle::TYPE_INT)
+    @flag = Fiddle::Function.new(lib['shared_flag'], [Fiddle::TYPE_INT], Fiddle::TYPE_INT)
+    @string = Fiddle::Function.new(lib['shared_string'],
+                                   [Fiddle::TYPE_INT, Fiddle::TYPE_VOIDP, Fiddle::TYPE_INT], Fiddle::TYPE_INT)
+    @truncated = Fiddle::Function.new(lib['shared_truncated'], [Fiddle::TYPE_INT], Fiddle::TYPE_INT)
+    open = Fiddle::Function.new(lib['shared_open'], [Fiddle::TYPE_VOIDP], Fiddle::TYPE_INT)
+    @buffer = Fiddle::Pointer.malloc(STRING_SIZE)
+    open.call(path) == 0
+  rescue Fiddle::DLError
+    false
+  end
+
+  def self.loaded?
+    @loaded = SharedData::load if @loaded.nil?
+    @loaded
+  end
+
+  def self.int(name)
+    @int.call(INTS[name])
+  end
+
+  def self.flag(name)
+    @flag.call(FLAGS[name]) == 1
+  end
+
+  # false when the value was too long for the snapshot and has to come from the api
+  def self.complete?(name)
+    @truncated.call(STRINGS[name]) == 0
+  end
+
+  def self.string(name)
+    length = @string.call(STRINGS[name], @buffer, STRING_SIZE)
+    length < 0 ? "" : @buffer.to_s(length).force_encoding('UTF-8')
+  end
+end
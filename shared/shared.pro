@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Reader library for the shared game state snapshot,
+# loaded by scripts (see shareddata.h).
+#
+#-------------------------------------------------
+
+TEMPLATE = lib
+CONFIG -= qt
+CONFIG += shared c99
+
+TARGET = ../shared
+
+QMAKE_CFLAGS += -fvisibility=hidden
+
+SOURCES += shareddatareader.c
+
+HEADERS += shareddata.h \
+    shareddatareader.h
@@ -0,0 +1,82 @@
+#ifndef SHAREDDATA_H
+#define SHAREDDATA_H
+
+/*
+ * Game state snapshot published by the client into a memory mapped file
+ * (path in api.ini, [SharedData] path=...). Shared by the writer in the
+ * client and the reader library loaded by scripts.
+ *
+ * Layout, version 1, all integers little endian as on the host:
+ *
+ *   offset  size  field
+ *   0       4     magic, SHARED_DATA_MAGIC
+ *   4       4     version, SHARED_DATA_VERSION
+ *   8       4     size of the whole segment
+ *   12      4     sequence; odd while the client is writing
+ *   16      4*8   ints, indexed by SharedDataInt
+ *   48      4     flags, one bit per SharedDataFlag
+ *   52      4     truncated, one bit per SharedDataString cut to fit
+ *   56      256*8 strings, indexed by SharedDataString, utf-8, nul terminated,
+ *                 cut at a character boundary when too long
+ *
+ * Readers copy what they need and retry while the sequence is odd or has
+ * changed since they started (seqlock); the client never waits for readers.
+ */
+
+#include <stdint.h>
+
+#define SHARED_DATA_MAGIC 0x53534246 /* "FBSS" */
+#define SHARED_DATA_VERSION 1
+#define SHARED_DATA_STRING_SIZE 256
+
+enum SharedDataInt {
+    SHARED_RT = 0,
+    SHARED_CT,
+    SHARED_HEALTH,
+    SHARED_CONCENTRATION,
+    SHARED_SPIRIT,
+    SHARED_FATIGUE,
+    SHARED_MANA,
+    SHARED_ROOM_ID,
+    SHARED_INT_COUNT
+};
+
+enum SharedDataFlag {
+    SHARED_STANDING = 0,
+    SHARED_SITTING,
+    SHARED_KNEELING,
+    SHARED_PRONE,
+    SHARED_STUNNED,
+    SHARED_BLEEDING,
+    SHARED_HIDDEN,
+    SHARED_INVISIBLE,
+    SHARED_WEBBED,
+    SHARED_JOINED,
+    SHARED_DEAD,
+    SHARED_FLAG_COUNT
+};
+
+enum SharedDataString {
+    SHARED_CHAR_NAME = 0,
+    SHARED_WIELD_RIGHT,
+    SHARED_WIELD_RIGHT_NOUN,
+    SHARED_WIELD_LEFT,
+    SHARED_WIELD_LEFT_NOUN,
+    SHARED_ROOM_TITLE,
+    SHARED_ROOM_EXITS,
+    SHARED_ROOM_ZONE,
+    SHARED_STRING_COUNT
+};
+
+typedef struct SharedData {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t sequence;
+    int32_t ints[SHARED_INT_COUNT];
+    uint32_t flags;
+    uint32_t truncated;
+    char strings[SHARED_STRING_COUNT][SHARED_DATA_STRING_SIZE];
+} SharedData;
+
+#endif // SHAREDDATA_H
@@ -0,0 +1,140 @@
+#include "shareddatareader.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const SharedData* shared = NULL;
+
+#ifdef _WIN32
+static HANDLE fileHandle = NULL;
+static HANDLE mappingHandle = NULL;
+#endif
+
+int shared_open(const char* path) {
+    void* memory;
+
+    shared_close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = NULL;
+        return -1;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, sizeof(SharedData), NULL);
+    if(mappingHandle == NULL) {
+        shared_close();
+        return -1;
+    }
+    memory = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, sizeof(SharedData));
+    if(memory == NULL) {
+        shared_close();
+        return -1;
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return -1;
+    memory = mmap(NULL, sizeof(SharedData), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(memory == MAP_FAILED) return -1;
+#endif
+
+    shared = (const SharedData*)memory;
+    if(__atomic_load_n(&shared->magic, __ATOMIC_ACQUIRE) != SHARED_DATA_MAGIC ||
+            shared->version != SHARED_DATA_VERSION || shared->size != sizeof(SharedData)) {
+        shared_close();
+        return -1;
+    }
+    return 0;
+}
+
+void shared_close(void) {
+#ifdef _WIN32
+    if(shared != NULL) UnmapViewOfFile(shared);
+    if(mappingHandle != NULL) CloseHandle(mappingHandle);
+    if(fileHandle != NULL) CloseHandle(fileHandle);
+    mappingHandle = NULL;
+    fileHandle = NULL;
+#else
+    if(shared != NULL) munmap((void*)shared, sizeof(SharedData));
+#endif
+    shared = NULL;
+}
+
+/* seqlock read: wait out a writer, copy, and retry if the sequence moved */
+static uint32_t read_begin(void) {
+    uint32_t sequence;
+    while((sequence = __atomic_load_n(&shared->sequence, __ATOMIC_ACQUIRE)) & 1) {
+    }
+    return sequence;
+}
+
+static int read_retry(uint32_t sequence) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&shared->sequence, __ATOMIC_RELAXED) != sequence;
+}
+
+int shared_int(int field) {
+    uint32_t sequence;
+    int value;
+
+    if(shared == NULL || field < 0 || field >= SHARED_INT_COUNT) return -1;
+    do {
+        sequence = read_begin();
+        value = __atomic_load_n(&shared->ints[field], __ATOMIC_RELAXED);
+    } while(read_retry(sequence));
+    return value;
+}
+
+int shared_flag(int flag) {
+    if(shared == NULL || flag < 0 || flag >= SHARED_FLAG_COUNT) return -1;
+    return (__atomic_load_n(&shared->flags, __ATOMIC_ACQUIRE) >> flag) & 1;
+}
+
+int shared_truncated(int field) {
+    if(shared == NULL || field < 0 || field >= SHARED_STRING_COUNT) return -1;
+    return (__atomic_load_n(&shared->truncated, __ATOMIC_ACQUIRE) >> field) & 1;
+}
+
+int shared_string(int field, char* out, int size) {
+    uint32_t sequence;
+    char buffer[SHARED_DATA_STRING_SIZE];
+    int length;
+
+    if(shared == NULL || field < 0 || field >= SHARED_STRING_COUNT || size <= 0) return -1;
+    do {
+        sequence = read_begin();
+        memcpy(buffer, shared->strings[field], SHARED_DATA_STRING_SIZE);
+    } while(read_retry(sequence));
+
+    buffer[SHARED_DATA_STRING_SIZE - 1] = '\0';
+    length = (int)strlen(buffer);
+    if(length > size - 1) length = size - 1;
+    memcpy(out, buffer, length);
+    out[length] = '\0';
+    return length;
+}
+
+int shared_read(SharedData* out) {
+    uint32_t sequence;
+
+    if(shared == NULL) return -1;
+    do {
+        sequence = read_begin();
+        memcpy(out, shared, sizeof(SharedData));
+    } while(read_retry(sequence));
+    return 0;
+}
+
+unsigned int shared_sequence(void) {
+    if(shared == NULL) return 0;
+    return __atomic_load_n(&shared->sequence, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,42 @@
+#ifndef SHAREDDATAREADER_H
+#define SHAREDDATAREADER_H
+
+/*
+ * Reader for the game state published by the client (see shareddata.h).
+ * Plain C so scripts can load it through an ffi (Ruby: Fiddle).
+ */
+
+#include "shareddata.h"
+
+#ifdef _WIN32
+#define SHARED_EXPORT __declspec(dllexport)
+#else
+#define SHARED_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maps the file at path; returns 0 on success */
+SHARED_EXPORT int shared_open(const char* path);
+SHARED_EXPORT void shared_close(void);
+
+/* SharedDataInt value, -1 when not open */
+SHARED_EXPORT int shared_int(int field);
+/* 1 or 0 for a SharedDataFlag, -1 when not open */
+SHARED_EXPORT int shared_flag(int flag);
+/* copies a SharedDataString into out; returns its length or -1 */
+SHARED_EXPORT int shared_string(int field, char* out, int size);
+/* 1 when a SharedDataString was cut to fit the snapshot, 0 if whole, -1 when not open */
+SHARED_EXPORT int shared_truncated(int field);
+/* consistent copy of the whole segment; returns 0 on success */
+SHARED_EXPORT int shared_read(SharedData* out);
+/* current sequence, changes on every update */
+SHARED_EXPORT unsigned int shared_sequence(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHAREDDATAREADER_H
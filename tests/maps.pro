@@ -0,0 +1,41 @@
+QT += testlib
+QT -= gui
+CONFIG += qt warn_on depend_includepath testcase
+
+TEMPLATE = app
+
+TARGET = testmaps
+
+# shares the directory with tests.pro, keep the build files apart
+OBJECTS_DIR = maps_obj
+MOC_DIR = maps_moc
+
+INCLUDEPATH += $$PWD/../gui $$PWD/..
+DEPENDPATH += $$PWD/../gui
+
+# Test
+SOURCES +=  tst_maps.cpp
+
+# Test dependencies
+
+SOURCES += \
+    $$PWD/../gui/maps/mapzone.cpp \
+    $$PWD/../gui/maps/mapnode.cpp \
+    $$PWD/../gui/maps/mapdestination.cpp \
+    $$PWD/../gui/maps/mapposition.cpp \
+    $$PWD/../gui/maps/maplabel.cpp \
+    $$PWD/../gui/maps/roomnode.cpp \
+    $$PWD/../gui/maps/mapgraph.cpp \
+    $$PWD/../gui/maps/maprouter.cpp \
+    $$PWD/../gui/maps/mapcache.cpp
+
+HEADERS += \
+    $$PWD/../gui/maps/mapzone.h \
+    $$PWD/../gui/maps/mapnode.h \
+    $$PWD/../gui/maps/mapdestination.h \
+    $$PWD/../gui/maps/mapposition.h \
+    $$PWD/../gui/maps/maplabel.h \
+    $$PWD/../gui/maps/roomnode.h \
+    $$PWD/../gui/maps/mapgraph.h \
+    $$PWD/../gui/maps/maprouter.h \
+    $$PWD/../gui/maps/mapcache.h
@@ -1,11 +1,11 @@
-QT += testlib xml gui
+QT += testlib xml gui widgets
 CONFIG += qt warn_on depend_includepath testcase
 
 TEMPLATE = app
 
 TARGET = testxml
 
-INCLUDEPATH += $$PWD/../gui
+INCLUDEPATH += $$PWD/../gui $$PWD/..
 DEPENDPATH += $$PWD/../gui
 
 # Test
@@ -14,13 +14,18 @@ SOURCES +=  tst_xml.cpp
 # Test dependencies
 
 include(../gui/xml/xml.pri)
+include(../log4qt/src/log4qt/log4qt.pri)
 
 SOURCES += \
     $$PWD/../gui/textutils.cpp \
     $$PWD/../gui/gamedatacontainer.cpp \
+    $$PWD/../gui/shareddataservice.cpp \
+    $$PWD/../gui/apisettings.cpp \
     $$PWD/../gui/hyperlinkutils.cpp
 
 HEADERS += \
     $$PWD/../gui/textutils.h \
     $$PWD/../gui/gamedatacontainer.h \
+    $$PWD/../gui/shareddataservice.h \
+    $$PWD/../gui/apisettings.h \
     $$PWD/../gui/hyperlinkutils.h
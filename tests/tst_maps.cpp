@@ -0,0 +1,343 @@
+#include <QtTest/QtTest>
+
+#include "maps/mapzone.h"
+#include "maps/mapnode.h"
+#include "maps/mapdestination.h"
+#include "maps/maplabel.h"
+#include "maps/mapgraph.h"
+#include "maps/maprouter.h"
+#include "maps/roomnode.h"
+#include "maps/mapcache.h"
+
+class MapsTest : public QObject {
+    Q_OBJECT
+public:
+private:
+    static MapNode* addNode(MapZone* zone, int id, QString name, QStringList notes = QStringList()) {
+        MapNode* node = new MapNode(id, name, notes, "");
+        node->setMapPosition(MapPosition(id * 10, 0, 0));
+        zone->getNodes().insert(id, node);
+        return node;
+    }
+
+    static void addArc(MapNode* node, int destId, QString exit, QString move = "") {
+        MapDestination* dest = new MapDestination(destId, exit, move);
+        dest->setHidden(false);
+        node->getDestinations().insert(destId, dest);
+    }
+
+    /* 1 -> 2 by two arcs, 2 -> 3, 3 leads to zone b, 4 can not be reached */
+    static MapZone* zoneA() {
+        MapZone* zone = new MapZone("a", "Zone A");
+        zone->setFile("a.xml");
+        zone->getLevels() << 0;
+
+        MapNode* gate = addNode(zone, 1, "Gate");
+        addArc(gate, 2, "north");
+        addArc(gate, 2, "climb", "go stairs");
+
+        MapNode* hall = addNode(zone, 2, "Hall");
+        addArc(hall, 3, "east");
+        addArc(hall, 1, "south");
+
+        MapNode* portal = addNode(zone, 3, "Portal room", QStringList() << "b.xml");
+        addArc(portal, 2, "west");
+        addArc(portal, 99, "nowhere");
+
+        addNode(zone, 4, "Island");
+
+        zone->setGraph(new MapGraph(zone));
+        return zone;
+    }
+
+    /* 10 leads back to zone a, 11 is one move north of it */
+    static MapZone* zoneB(QString portalName) {
+        MapZone* zone = new MapZone("b", "Zone B");
+        zone->setFile("b.xml");
+        zone->getLevels() << 0;
+
+        MapNode* portal = addNode(zone, 10, portalName, QStringList() << "a.xml");
+        addArc(portal, 11, "north");
+
+        MapNode* market = addNode(zone, 11, "Market");
+        addArc(market, 10, "south");
+
+        zone->setGraph(new MapGraph(zone));
+        return zone;
+    }
+
+    static void writeFile(const QString& path, const QByteArray& content) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+    static void compareZones(MapZone* loaded, MapZone* zone) {
+        QCOMPARE(loaded->getId(), zone->getId());
+        QCOMPARE(loaded->getName(), zone->getName());
+        QCOMPARE(loaded->getFile(), zone->getFile());
+        QCOMPARE(loaded->getXMin(), zone->getXMin());
+        QCOMPARE(loaded->getXMax(), zone->getXMax());
+        QCOMPARE(loaded->getYMin(), zone->getYMin());
+        QCOMPARE(loaded->getYMax(), zone->getYMax());
+        QCOMPARE(loaded->getLevels(), zone->getLevels());
+
+        QCOMPARE(loaded->getNodes().size(), zone->getNodes().size());
+        foreach(MapNode* node, zone->getNodes()) {
+            MapNode* copy = loaded->getNodes().value(node->getId());
+            QVERIFY(copy != NULL);
+            QCOMPARE(copy->getName(), node->getName());
+            QCOMPARE(copy->getDesc(), node->getDesc());
+            QCOMPARE(copy->getNotes(), node->getNotes());
+            QCOMPARE(copy->getColor(), node->getColor());
+            QCOMPARE(copy->getPosition().getX(), node->getPosition().getX());
+            QCOMPARE(copy->getPosition().getY(), node->getPosition().getY());
+            QCOMPARE(copy->getPosition().getZ(), node->getPosition().getZ());
+
+            // arcs to the same room keep their order
+            QCOMPARE(copy->getDestinations().size(), node->getDestinations().size());
+            foreach(int key, node->getDestinations().uniqueKeys()) {
+                QList<MapDestination*> arcs = node->getDestinations().values(key);
+                QList<MapDestination*> copies = copy->getDestinations().values(key);
+                QCOMPARE(copies.size(), arcs.size());
+                for(int i = 0; i < arcs.size(); i++) {
+                    QCOMPARE(copies.at(i)->getDestId(), arcs.at(i)->getDestId());
+                    QCOMPARE(copies.at(i)->getExit(), arcs.at(i)->getExit());
+                    QCOMPARE(copies.at(i)->getMove(), arcs.at(i)->getMove());
+                    QCOMPARE(copies.at(i)->getHidden(), arcs.at(i)->getHidden());
+                }
+            }
+        }
+
+        QCOMPARE(loaded->getLabels().size(), zone->getLabels().size());
+        for(int i = 0; i < zone->getLabels().size(); i++) {
+            QCOMPARE(loaded->getLabels().at(i)->getText(), zone->getLabels().at(i)->getText());
+            QCOMPARE(loaded->getLabels().at(i)->getPosition().getX(), zone->getLabels().at(i)->getPosition().getX());
+            QCOMPARE(loaded->getLabels().at(i)->getPosition().getY(), zone->getLabels().at(i)->getPosition().getY());
+            QCOMPARE(loaded->getLabels().at(i)->getPosition().getZ(), zone->getLabels().at(i)->getPosition().getZ());
+        }
+    }
+
+    static void deleteZone(MapZone* zone) {
+        foreach(MapNode* node, zone->getNodes()) {
+            qDeleteAll(node->getDestinations());
+            delete node;
+        }
+        qDeleteAll(zone->getLabels());
+        delete zone->getGraph();
+        delete zone;
+    }
+
+private slots:
+
+    void findPathTestCase() {
+        MapZone* zone = zoneA();
+        MapGraph* graph = zone->getGraph();
+
+        // the arc added last to a room wins, its move is used over the exit
+        QCOMPARE(graph->findPath(1, 2), QString("go stairs"));
+        QCOMPARE(graph->findPath(1, 3), QString("go stairs,east"));
+        QCOMPARE(graph->findPath(3, 1), QString("west,south"));
+
+        deleteZone(zone);
+    }
+
+    void findPathNoPathTestCase() {
+        MapZone* zone = zoneA();
+        MapGraph* graph = zone->getGraph();
+
+        QCOMPARE(graph->findPath(1, 4), QString(""));
+        QCOMPARE(graph->findPath(4, 1), QString(""));
+        QCOMPARE(graph->findPath(1, 42), QString(""));
+        QCOMPARE(graph->findPath(42, 1), QString(""));
+        QCOMPARE(graph->findPath(1, 1), QString(""));
+        // arcs to rooms outside the zone are dropped
+        QVERIFY(!graph->contains(99));
+        QCOMPARE(graph->nodeCount(), 4);
+
+        deleteZone(zone);
+    }
+
+    void findPathCacheTestCase() {
+        MapZone* zone = zoneA();
+        MapGraph* graph = zone->getGraph();
+
+        QVERIFY(!graph->isCached(1, 3));
+        QString path = graph->findPath(1, 3);
+        QVERIFY(graph->isCached(1, 3));
+        QVERIFY(!graph->isCached(3, 1));
+        QCOMPARE(graph->findPath(1, 3), path);
+
+        // no path is cached as well
+        graph->findPath(1, 4);
+        QVERIFY(graph->isCached(1, 4));
+        QCOMPARE(graph->findPath(1, 4), QString(""));
+
+        deleteZone(zone);
+    }
+
+    void distancesTestCase() {
+        MapZone* zone = zoneA();
+
+        QVector<int> result;
+        zone->getGraph()->distances(1, QVector<int>() << 2 << 3 << 4 << 1 << 42, result);
+        QCOMPARE(result, QVector<int>() << 1 << 2 << -1 << 0 << -1);
+
+        zone->getGraph()->distances(42, QVector<int>() << 1 << 2, result);
+        QCOMPARE(result, QVector<int>() << -1 << -1);
+
+        deleteZone(zone);
+    }
+
+    void findRouteByNameTestCase() {
+        MapZone* a = zoneA();
+        MapZone* b = zoneB("Portal room");
+
+        QMap<QString, MapZone*> zones;
+        zones.insert("a", a);
+        zones.insert("b", b);
+        QHash<QString, QString> connections;
+        connections.insert("a.xml", "a");
+        connections.insert("b.xml", "b");
+
+        // no room hashes, rooms are matched by name and a note leading back
+        MapRouter router;
+        router.build(zones, connections, QMultiHash<QString, RoomNode>());
+
+        QVERIFY(router.isConnected("a", "b"));
+        QCOMPARE(router.findRoute(RoomNode("a", 0, 1), "b", 11), QString("go stairs,east,north"));
+        QCOMPARE(router.findRoute(RoomNode("b", 0, 11), "a", 1), QString("south,west,south"));
+        QCOMPARE(router.findRoute(RoomNode("a", 0, 1), "a", 3), QString("go stairs,east"));
+        QCOMPARE(router.findRoute(RoomNode("a", 0, 4), "b", 11), QString(""));
+        QCOMPARE(router.findRoute(RoomNode("a", 0, 1), "c", 1), QString(""));
+        QCOMPARE(router.findPath("a", 1, 3), QString("go stairs,east"));
+
+        router.clear();
+        QCOMPARE(router.findPath("a", 1, 3), QString(""));
+        deleteZone(a);
+        deleteZone(b);
+    }
+
+    void findRouteByHashTestCase() {
+        MapZone* a = zoneA();
+        MapZone* b = zoneB("Portal landing");
+
+        QMap<QString, MapZone*> zones;
+        zones.insert("a", a);
+        zones.insert("b", b);
+        QHash<QString, QString> connections;
+        connections.insert("a.xml", "a");
+        connections.insert("b.xml", "b");
+
+        QMultiHash<QString, RoomNode> roomNodes;
+        roomNodes.insert("portal", RoomNode("a", 0, 3));
+        roomNodes.insert("portal", RoomNode("b", 0, 10));
+
+        MapRouter router;
+        router.build(zones, connections, roomNodes);
+        QCOMPARE(router.findRoute(RoomNode("a", 0, 1), "b", 11), QString("go stairs,east,north"));
+
+        // without the hash the differently named rooms are not linked
+        router.build(zones, connections, QMultiHash<QString, RoomNode>());
+        QVERIFY(!router.isConnected("a", "b"));
+        QCOMPARE(router.findRoute(RoomNode("a", 0, 1), "b", 11), QString(""));
+
+        router.clear();
+        deleteZone(a);
+        deleteZone(b);
+    }
+
+    void cacheRoundTripTestCase() {
+        QTemporaryDir mapDir;
+        QTemporaryDir cacheDir;
+        QVERIFY(mapDir.isValid() && cacheDir.isValid());
+        writeFile(mapDir.filePath("a.xml"), "<zone id=\"a\" name=\"Zone A\"></zone>");
+
+        CachedZone cached;
+        cached.zone = zoneA();
+        cached.zone->setXMin(-20);
+        cached.zone->setXMax(40);
+        cached.zone->setYMin(-5);
+        cached.zone->setYMax(5);
+        cached.zone->getNodes().value(1)->setDesc(QStringList() << "A heavy gate.");
+        cached.zone->getNodes().value(2)->setColor("#FF0000");
+        cached.zone->getNodes().value(2)->getDestinations().value(1)->setHidden(true);
+        MapLabel* label = new MapLabel("Gate house");
+        label->setPosition(MapPosition(-15, 3, 0));
+        cached.zone->getLabels() << label;
+        cached.xmlId = "a";
+        cached.nodeOrder << 3 << 1 << 2;
+        cached.hashes << qMakePair(QString("portal"), RoomNode("", 0, 3))
+                      << qMakePair(QString("gate"), RoomNode("", 0, 1));
+
+        MapCache cache(QDir(mapDir.path()), QDir(cacheDir.path()));
+        cache.save("a.xml", cached);
+
+        CachedZone loaded;
+        QVERIFY(cache.load("a.xml", loaded));
+        QVERIFY(loaded.zone != NULL);
+        QCOMPARE(loaded.xmlId, cached.xmlId);
+        compareZones(loaded.zone, cached.zone);
+        QCOMPARE(loaded.nodeOrder, cached.nodeOrder);
+
+        QCOMPARE(loaded.hashes.size(), cached.hashes.size());
+        for(int i = 0; i < cached.hashes.size(); i++) {
+            QCOMPARE(loaded.hashes.at(i).first, cached.hashes.at(i).first);
+            QCOMPARE(loaded.hashes.at(i).second.getLevel(), cached.hashes.at(i).second.getLevel());
+            QCOMPARE(loaded.hashes.at(i).second.getNodeId(), cached.hashes.at(i).second.getNodeId());
+        }
+
+        deleteZone(loaded.zone);
+        deleteZone(cached.zone);
+    }
+
+    void cacheStaleTestCase() {
+        QTemporaryDir mapDir;
+        QTemporaryDir cacheDir;
+        QVERIFY(mapDir.isValid() && cacheDir.isValid());
+        QString xml = mapDir.filePath("a.xml");
+        writeFile(xml, "<zone id=\"a\" name=\"Zone A\"></zone>");
+
+        CachedZone cached;
+        cached.zone = zoneA();
+        cached.xmlId = "a";
+
+        MapCache cache(QDir(mapDir.path()), QDir(cacheDir.path()));
+        cache.save("a.xml", cached);
+        deleteZone(cached.zone);
+
+        // another modification time
+        CachedZone loaded;
+        QFile file(xml);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QDateTime modified = QFileInfo(xml).lastModified();
+        QVERIFY(file.setFileTime(modified.addSecs(3600), QFileDevice::FileModificationTime));
+        file.close();
+        QVERIFY(!cache.load("a.xml", loaded));
+        QVERIFY(loaded.zone == NULL);
+
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+        file.close();
+        QVERIFY(cache.load("a.xml", loaded));
+        deleteZone(loaded.zone);
+
+        // another size with the same modification time
+        CachedZone resized;
+        QVERIFY(file.open(QIODevice::Append));
+        file.write("\n");
+        file.flush();
+        QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+        file.close();
+        QVERIFY(!cache.load("a.xml", resized));
+        QVERIFY(resized.zone == NULL);
+
+        // no cache file at all
+        CachedZone missing;
+        QVERIFY(!cache.load("b.xml", missing));
+    }
+};
+
+QTEST_APPLESS_MAIN(MapsTest)
+
+#include "tst_maps.moc"